@@ -0,0 +1,69 @@
+#pragma once
+#include <pthread.h>
+#include <sched.h>
+#include <mutex>
+#include <vector>
+
+// Ядра, на которых процессу разрешено работать
+inline std::vector<int> available_cores() {
+    std::vector<int> cores;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cores.push_back(cpu);
+        }
+    }
+    return cores;
+}
+
+// Привязка текущего потока к набору ядер; потоки, созданные после, наследуют привязку
+inline bool pin_current_thread(const std::vector<int> &cores) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cores) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Непересекающиеся группы ядер. Задача берет группу на время работы, так что
+// одновременно выполняемые задачи не делят ядра и не искажают друг другу замеры.
+class CoreReservations {
+private:
+    std::vector<std::vector<int>> groups;
+    std::vector<int> free_groups;
+    std::mutex mutex;
+
+public:
+    CoreReservations(const std::vector<int> &cores, int group_size) {
+        for (size_t start = 0; start + group_size <= cores.size(); start += group_size) {
+            groups.emplace_back(cores.begin() + start, cores.begin() + start + group_size);
+            free_groups.push_back(groups.size() - 1);
+        }
+        // Ядер меньше, чем нужно одной задаче: единственная группа из всех ядер
+        if (groups.empty()) {
+            groups.push_back(cores);
+            free_groups.push_back(0);
+        }
+    }
+
+    size_t size() const {
+        return groups.size();
+    }
+
+    // Вызывается не больше чем из size() потоков одновременно, поэтому группа всегда есть
+    int acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        int group = free_groups.back();
+        free_groups.pop_back();
+        return group;
+    }
+
+    void release(int group) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_groups.push_back(group);
+    }
+
+    const std::vector<int> &cores(int group) const {
+        return groups[group];
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+// Медиана и 95% доверительный интервал (перцентильный бутстрап с фиксированным зерном,
+// чтобы повторный запуск давал те же границы)
+struct SampleStats {
+    int count = 0;
+    double median = 0;
+    double ci_low = 0;
+    double ci_high = 0;
+    double min = 0;
+    double max = 0;
+};
+
+inline double median_of(std::vector<double> values) {
+    if (values.empty()) return 0;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 == 1) return upper;
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2;
+}
+
+inline std::vector<double> resample(const std::vector<double> &values, std::mt19937 &rng) {
+    std::uniform_int_distribution<size_t> pick(0, values.size() - 1);
+    std::vector<double> result(values.size());
+    for (auto &v : result) v = values[pick(rng)];
+    return result;
+}
+
+inline std::pair<double, double> percentile_interval(std::vector<double> values, double confidence) {
+    std::sort(values.begin(), values.end());
+    double alpha = (1.0 - confidence) / 2;
+    size_t lo = static_cast<size_t>(alpha * (values.size() - 1));
+    size_t hi = static_cast<size_t>((1.0 - alpha) * (values.size() - 1));
+    return {values[lo], values[hi]};
+}
+
+inline SampleStats summarize(const std::vector<double> &values,
+                             int resamples = 2000, double confidence = 0.95) {
+    SampleStats stats;
+    stats.count = values.size();
+    if (values.empty()) return stats;
+    stats.median = median_of(values);
+    stats.min = *std::min_element(values.begin(), values.end());
+    stats.max = *std::max_element(values.begin(), values.end());
+
+    std::mt19937 rng(12345);
+    std::vector<double> medians(resamples);
+    for (auto &m : medians) m = median_of(resample(values, rng));
+    std::tie(stats.ci_low, stats.ci_high) = percentile_interval(medians, confidence);
+    return stats;
+}
+
+// Ускорение как отношение медиан; интервал — бутстрап по обеим выборкам независимо
+inline SampleStats summarize_ratio(const std::vector<double> &numerator,
+                                   const std::vector<double> &denominator,
+                                   int resamples = 2000, double confidence = 0.95) {
+    SampleStats stats;
+    stats.count = std::min(numerator.size(), denominator.size());
+    if (numerator.empty() || denominator.empty()) return stats;
+    stats.median = median_of(numerator) / median_of(denominator);
+
+    std::mt19937 rng(54321);
+    std::vector<double> ratios(resamples);
+    for (auto &r : ratios) {
+        r = median_of(resample(numerator, rng)) / median_of(resample(denominator, rng));
+    }
+    std::tie(stats.ci_low, stats.ci_high) = percentile_interval(ratios, confidence);
+    stats.min = *std::min_element(ratios.begin(), ratios.end());
+    stats.max = *std::max_element(ratios.begin(), ratios.end());
+    return stats;
+}
+
+inline std::string to_json(const SampleStats &stats) {
+    std::ostringstream out;
+    out << std::setprecision(10)
+        << "{\"n\": " << stats.count
+        << ", \"median\": " << stats.median
+        << ", \"ci_low\": " << stats.ci_low
+        << ", \"ci_high\": " << stats.ci_high
+        << ", \"min\": " << stats.min
+        << ", \"max\": " << stats.max << "}";
+    return out.str();
+}
+
+inline std::string to_json(const std::vector<double> &values) {
+    std::ostringstream out;
+    out << std::setprecision(10) << "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i) out << ", ";
+        out << values[i];
+    }
+    out << "]";
+    return out.str();
+}
+
+// Детерминированное зерно для (повторения, раунда, потока) без привязки к часам
+inline unsigned int derive_seed(unsigned int base, unsigned int round, unsigned int thread) {
+    std::seed_seq seq{base, round, thread};
+    unsigned int seed;
+    seq.generate(&seed, &seed + 1);
+    return seed;
+}
@@ -0,0 +1,287 @@
+#pragma once
+#include "Solution.h"
+#include "Cooling.h"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <utility>
+
+// Массовый мультистарт на маленьких экземплярах: тысячи легких цепочек отжига в виде
+// корутин C++20, которые уступают поток каждые yield_every итераций и по кругу выполняются
+// на фиксированном наборе рабочих потоков. Вместо SchedulingSolution (матрица N×M и mt19937
+// на каждую копию) цепочка хранит назначение uint16 на работу, загрузки и 8-байтовый генератор;
+// все массивы цепочек лежат подряд в общих буферах.
+
+// splitmix64: состояние — одно 64-битное слово
+struct SmallRng {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Равномерно в [0, bound) без деления (умножение с сдвигом, смещение пренебрежимо)
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(static_cast<uint32_t>(next())) * bound) >> 32);
+    }
+
+    double unit() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Корутина цепочки: приостанавливается сразу после создания и после каждой порции итераций
+class ChainTask {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        ChainTask get_return_object() {
+            return ChainTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit ChainTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    ChainTask(ChainTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    ChainTask &operator=(ChainTask &&other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    ChainTask(const ChainTask &) = delete;
+    ChainTask &operator=(const ChainTask &) = delete;
+    ~ChainTask() {
+        if (handle) handle.destroy();
+    }
+
+    // Продвигает цепочку до следующей точки уступки; false — цепочка завершилась
+    bool resume() {
+        handle.resume();
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+        return !handle.done();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Рекорд по всем цепочкам без блокировок: стоимость и номер цепочки упакованы в одно
+// 64-битное слово, меньшее слово — лучший рекорд
+class AtomicBestTracker {
+private:
+    static constexpr int ID_BITS = 24;
+    std::atomic<uint64_t> packed{UINT64_MAX};
+
+public:
+    static constexpr uint32_t MAX_CHAINS = 1u << ID_BITS;
+    // На стоимость остается 64 - ID_BITS бит; K1 не превышает суммарной загрузки
+    static constexpr uint64_t COST_LIMIT = uint64_t(1) << (64 - ID_BITS);
+
+    // true, если рекорд обновлен
+    bool offer(uint64_t cost, uint32_t chain) {
+        uint64_t candidate = (cost << ID_BITS) | chain;
+        uint64_t current = packed.load(std::memory_order_relaxed);
+        while (candidate < current) {
+            if (packed.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    uint64_t cost() const { return packed.load() >> ID_BITS; }
+    uint32_t chain() const { return packed.load() & (MAX_CHAINS - 1); }
+};
+
+struct CoroutineConfig {
+    int chains = 10000;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    int yield_every = 64;                 // итераций между уступками потока
+    long long iterations_per_chain = 2000;
+    int max_no_improvement = 500;         // ходов без улучшения рекорда цепочки до остановки
+    unsigned int seed = 1;
+};
+
+struct CoroutineResult {
+    std::shared_ptr<SchedulingSolution> best;
+    long long iterations = 0;
+    size_t state_bytes = 0;   // память под состояние всех цепочек
+    double seconds = 0;
+};
+
+class CoroutineChainPool {
+private:
+    // Скаляры цепочки; массивы — срезы общих буферов
+    struct ChainState {
+        SmallRng rng;
+        uint32_t iter = 0;
+        uint32_t no_improvement = 0;
+        int64_t cost = 0;
+        int64_t best_cost = 0;
+    };
+
+    const CoroutineConfig config;
+    const TemperatureLaw &law;
+    std::vector<uint32_t> durations;
+    int num_jobs;
+    int num_processors;
+
+    std::vector<ChainState> states;
+    std::vector<uint16_t> assignments;       // chains × N
+    std::vector<uint16_t> best_assignments;  // chains × N
+    std::vector<int64_t> loads;              // chains × M
+    AtomicBestTracker tracker;
+    std::atomic<long long> total_iterations{0};
+
+    uint16_t *assignment(int chain) { return &assignments[static_cast<size_t>(chain) * num_jobs]; }
+    uint16_t *best_assignment(int chain) { return &best_assignments[static_cast<size_t>(chain) * num_jobs]; }
+    int64_t *chain_loads(int chain) { return &loads[static_cast<size_t>(chain) * num_processors]; }
+
+    int64_t spread(const int64_t *load) const {
+        int64_t lo = load[0], hi = load[0];
+        for (int p = 1; p < num_processors; ++p) {
+            lo = std::min(lo, load[p]);
+            hi = std::max(hi, load[p]);
+        }
+        return hi - lo;
+    }
+
+    void initialize(int chain) {
+        ChainState &state = states[chain];
+        state.rng.state = (static_cast<uint64_t>(config.seed) << 32) ^ (chain * 0x632be59bd9b4e019ULL);
+        uint16_t *current = assignment(chain);
+        int64_t *load = chain_loads(chain);
+        for (int job = 0; job < num_jobs; ++job) {
+            current[job] = state.rng.below(num_processors);
+            load[current[job]] += durations[job];
+        }
+        state.cost = state.best_cost = spread(load);
+        std::copy(current, current + num_jobs, best_assignment(chain));
+        tracker.offer(state.best_cost, chain);
+    }
+
+    // Один ход: перенос случайной работы на другой процессор, при отказе — откат
+    void step(int chain, ChainState &state, uint16_t *current, int64_t *load) {
+        int job = state.rng.below(num_jobs);
+        int from = current[job];
+        int to = state.rng.below(num_processors - 1);
+        if (to >= from) to++;
+        load[from] -= durations[job];
+        load[to] += durations[job];
+        int64_t cost = spread(load);
+        double delta = static_cast<double>(cost - state.cost);
+        double temperature = law.get_next_temperature(state.iter);
+        if (delta <= 0 || std::exp(-delta / temperature) >= state.rng.unit()) {
+            current[job] = to;
+            state.cost = cost;
+            if (cost < state.best_cost) {
+                state.best_cost = cost;
+                state.no_improvement = 0;
+                std::copy(current, current + num_jobs, best_assignment(chain));
+                tracker.offer(cost, chain);
+            } else {
+                state.no_improvement++;
+            }
+        } else {
+            load[from] += durations[job];
+            load[to] -= durations[job];
+            state.no_improvement++;
+        }
+        state.iter++;
+    }
+
+    ChainTask anneal(int chain) {
+        ChainState &state = states[chain];
+        uint16_t *current = assignment(chain);
+        int64_t *load = chain_loads(chain);
+        while (state.iter < config.iterations_per_chain &&
+               state.no_improvement < static_cast<uint32_t>(config.max_no_improvement) && state.best_cost > 0) {
+            uint32_t slice_end = std::min<long long>(state.iter + config.yield_every, config.iterations_per_chain);
+            uint32_t slice_start = state.iter;
+            while (state.iter < slice_end) step(chain, state, current, load);
+            total_iterations.fetch_add(slice_end - slice_start, std::memory_order_relaxed);
+            co_await std::suspend_always{};
+        }
+    }
+
+    // Рабочий поток по кругу продвигает свои цепочки, пока все не завершатся
+    void worker(int index) {
+        std::deque<ChainTask> ready;
+        for (int chain = index; chain < config.chains; chain += config.workers) {
+            initialize(chain);
+            ready.push_back(anneal(chain));
+        }
+        while (!ready.empty()) {
+            ChainTask task = std::move(ready.front());
+            ready.pop_front();
+            if (task.resume()) ready.push_back(std::move(task));
+        }
+    }
+
+public:
+    CoroutineChainPool(const SchedulingSolution &instance, const TemperatureLaw &law, const CoroutineConfig &config) :
+        config(config), law(law), durations(instance.get_job_times()),
+        num_jobs(instance.get_num_jobs()), num_processors(instance.get_num_processors()) {
+        if (num_processors < 2 || num_processors > 65536) {
+            throw std::runtime_error("Coroutine chains need 2..65536 processors");
+        }
+        if (config.chains < 1 || static_cast<uint32_t>(config.chains) > AtomicBestTracker::MAX_CHAINS) {
+            throw std::runtime_error("Coroutine chains: chain count out of range");
+        }
+        if (config.workers < 1) {
+            throw std::runtime_error("Coroutine chains need at least one worker thread");
+        }
+        if (static_cast<uint64_t>(instance.get_total_load()) >= AtomicBestTracker::COST_LIMIT) {
+            throw std::runtime_error("Coroutine chains pack cost next to the chain id; total load is too large");
+        }
+        // У закона с обратной связью состояние своё на цепочку; здесь закон общий и неизменяемый
+        if (dynamic_cast<const AdaptiveLaw *>(&law)) {
+            throw std::runtime_error("Coroutine chains share one stateless law; adaptive is not supported");
+        }
+        states.resize(config.chains);
+        assignments.resize(static_cast<size_t>(config.chains) * num_jobs);
+        best_assignments.resize(static_cast<size_t>(config.chains) * num_jobs);
+        loads.assign(static_cast<size_t>(config.chains) * num_processors, 0);
+    }
+
+    CoroutineResult run() {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(config.workers);
+        for (int i = 0; i < config.workers; ++i) {
+            threads.emplace_back([this, i, &errors]() {
+                try {
+                    worker(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        for (auto &error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        CoroutineResult result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.iterations = total_iterations.load();
+        result.state_bytes = states.size() * sizeof(ChainState) +
+                             (assignments.size() + best_assignments.size()) * sizeof(uint16_t) +
+                             loads.size() * sizeof(int64_t);
+        const uint16_t *winner = best_assignment(tracker.chain());
+        result.best = make_scheduling_solution(num_jobs, num_processors, durations, config.seed);
+        result.best->set_assignment(std::vector<int>(winner, winner + num_jobs));
+        return result;
+    }
+};
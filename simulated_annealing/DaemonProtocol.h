@@ -0,0 +1,232 @@
+#pragma once
+#include "Islands.h"
+#include <charconv>
+#include <cctype>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Запрос к демону. Две формы записи:
+//  * JSON-строка: {"id":1,"processors":4,"threads":2,"rounds":50,"stale":3,"law":"cauchy",
+//                  "stagnation":90,"refine":0,"durations":[5,3,8]}
+//  * бинарный кадр: u32 длина, затем u32 'SAQ1', id, processors, threads, rounds, stale, law, N
+//    и N байт длительностей (все числа little-endian). Длительности больше 255 передаются
+//    только в JSON.
+struct SolveRequest {
+    uint32_t id = 0;
+    int num_processors = 0;
+    int threads = 0;          // 0 — весь пул
+    int max_rounds = 100;
+    int stale_rounds = 3;
+    std::string law = "cauchy";
+    int stagnation = -1;      // ходов без рекорда до подогрева адаптивного закона; -1 — по умолчанию
+    bool refine = false;      // при попадании в кэш — короткая доводка вместо мгновенного ответа
+    std::vector<uint32_t> durations;
+};
+
+// Ответ: промежуточный рекорд после каждого раунда и итог с назначением работ
+struct SolveProgress {
+    uint32_t id;
+    int round;
+    double cost;
+};
+
+struct SolveResult {
+    uint32_t id;
+    int rounds;
+    double cost;
+    double elapsed_ms;
+    bool cached = false;
+    std::vector<int64_t> loads;
+    std::vector<int> assignment;
+};
+
+constexpr uint32_t REQUEST_MAGIC = 0x31514153;   // "SAQ1"
+constexpr uint32_t PROGRESS_MAGIC = 0x31504153;  // "SAP1"
+constexpr uint32_t FINAL_MAGIC = 0x31464153;     // "SAF1"
+constexpr uint32_t ERROR_MAGIC = 0x31454153;     // "SAE1"
+
+inline const char *LAW_NAMES[] = {"boltzmann", "cauchy", "logcauchy", "adaptive"};
+
+// ---------- JSON ----------
+
+// Разбор плоского объекта известного формата без полноценного JSON-парсера
+class JsonFields {
+private:
+    const std::string &text;
+
+    size_t value_position(const char *key) const {
+        std::string quoted = std::string("\"") + key + "\"";
+        size_t pos = text.find(quoted);
+        if (pos == std::string::npos) return std::string::npos;
+        pos = text.find(':', pos + quoted.size());
+        if (pos == std::string::npos) return pos;
+        pos++;
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        return pos;
+    }
+
+public:
+    explicit JsonFields(const std::string &line) : text(line) {}
+
+    long long number(const char *key, long long fallback) const {
+        size_t pos = value_position(key);
+        if (pos == std::string::npos) return fallback;
+        long long value = fallback;
+        std::from_chars(text.data() + pos, text.data() + text.size(), value);
+        return value;
+    }
+
+    std::string string(const char *key, const std::string &fallback) const {
+        size_t pos = value_position(key);
+        if (pos == std::string::npos || text[pos] != '"') return fallback;
+        size_t end = text.find('"', pos + 1);
+        if (end == std::string::npos) return fallback;
+        return text.substr(pos + 1, end - pos - 1);
+    }
+
+    bool number_array(const char *key, std::vector<long long> &values) const {
+        size_t pos = value_position(key);
+        if (pos == std::string::npos || text[pos] != '[') return false;
+        const char *ptr = text.data() + pos + 1;
+        const char *end = text.data() + text.size();
+        while (ptr < end) {
+            while (ptr < end && (std::isspace(static_cast<unsigned char>(*ptr)) || *ptr == ',')) ptr++;
+            if (ptr < end && *ptr == ']') return true;
+            long long value;
+            auto parsed = std::from_chars(ptr, end, value);
+            if (parsed.ec != std::errc()) return false;
+            values.push_back(value);
+            ptr = parsed.ptr;
+        }
+        return false;
+    }
+};
+
+inline bool parse_json_request(const std::string &line, SolveRequest &request, std::string &error) {
+    JsonFields fields(line);
+    request.id = fields.number("id", 0);
+    request.num_processors = fields.number("processors", 0);
+    request.threads = fields.number("threads", 0);
+    request.max_rounds = fields.number("rounds", request.max_rounds);
+    request.stale_rounds = fields.number("stale", request.stale_rounds);
+    request.law = fields.string("law", request.law);
+    request.stagnation = fields.number("stagnation", request.stagnation);
+    request.refine = fields.number("refine", 0) != 0;
+    std::vector<long long> durations;
+    if (!fields.number_array("durations", durations)) {
+        error = "missing or malformed durations";
+        return false;
+    }
+    request.durations.reserve(durations.size());
+    for (long long d : durations) {
+        if (d < 0 || d > std::numeric_limits<uint32_t>::max()) {
+            error = "duration out of range 0..4294967295";
+            return false;
+        }
+        request.durations.push_back(static_cast<uint32_t>(d));
+    }
+    return true;
+}
+
+template <typename T>
+void append_json_array(std::string &out, const std::vector<T> &values) {
+    char digits[24];
+    out += '[';
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i) out += ',';
+        auto result = std::to_chars(digits, digits + sizeof(digits), values[i]);
+        out.append(digits, result.ptr);
+    }
+    out += ']';
+}
+
+inline void append_json_progress(std::string &out, const SolveProgress &progress) {
+    out += "{\"id\":" + std::to_string(progress.id) + ",\"type\":\"progress\",\"round\":" +
+           std::to_string(progress.round) + ",\"cost\":" + std::to_string(static_cast<long long>(progress.cost)) + "}\n";
+}
+
+inline void append_json_result(std::string &out, const SolveResult &result) {
+    out += "{\"id\":" + std::to_string(result.id) + ",\"type\":\"final\",\"cost\":" +
+           std::to_string(static_cast<long long>(result.cost)) + ",\"rounds\":" + std::to_string(result.rounds) +
+           ",\"elapsed_ms\":" + std::to_string(result.elapsed_ms) +
+           ",\"cached\":" + (result.cached ? "true" : "false") + ",\"loads\":";
+    append_json_array(out, result.loads);
+    out += ",\"assignment\":";
+    append_json_array(out, result.assignment);
+    out += "}\n";
+}
+
+inline void append_json_error(std::string &out, uint32_t id, const std::string &message) {
+    out += "{\"id\":" + std::to_string(id) + ",\"type\":\"error\",\"message\":\"" + message + "\"}\n";
+}
+
+// ---------- бинарный формат ----------
+
+struct BinaryRequestHeader {
+    uint32_t magic;
+    uint32_t id;
+    uint32_t processors;
+    uint32_t threads;
+    uint32_t rounds;
+    uint32_t stale;
+    uint32_t law;
+    uint32_t num_jobs;
+};
+
+// Кадр ответа: u32 длина, затем заголовок и count номеров процессоров (только в итоговом).
+// В flags бит 0 — ответ взят из кэша.
+struct BinaryResponseHeader {
+    uint32_t magic;
+    uint32_t id;
+    uint64_t cost;
+    uint32_t round;
+    uint32_t elapsed_us;
+    uint32_t count;
+    uint32_t flags;
+};
+
+constexpr uint32_t RESPONSE_FLAG_CACHED = 1;
+
+inline bool read_binary_request(int fd, SolveRequest &request, std::string &error) {
+    uint32_t length;
+    if (!read_all(fd, &length, sizeof(length))) return false;
+    BinaryRequestHeader header;
+    if (length < sizeof(header) || !read_all(fd, &header, sizeof(header))) {
+        error = "truncated request";
+        return false;
+    }
+    if (header.magic != REQUEST_MAGIC || length != sizeof(header) + header.num_jobs ||
+        header.law >= std::size(LAW_NAMES)) {
+        error = "malformed request header";
+        return false;
+    }
+    request.id = header.id;
+    request.num_processors = header.processors;
+    request.threads = header.threads;
+    request.max_rounds = header.rounds;
+    request.stale_rounds = header.stale;
+    request.law = LAW_NAMES[header.law];
+    std::vector<uint8_t> durations(header.num_jobs);
+    if (header.num_jobs != 0 && !read_all(fd, durations.data(), header.num_jobs)) return false;
+    request.durations.assign(durations.begin(), durations.end());
+    return true;
+}
+
+inline void append_binary_frame(std::string &out, uint32_t magic, uint32_t id, double cost,
+                                int round, double elapsed_ms, const std::vector<int> &assignment = {},
+                                uint32_t flags = 0) {
+    BinaryResponseHeader header = {magic, id, static_cast<uint64_t>(cost), static_cast<uint32_t>(round),
+                                   static_cast<uint32_t>(elapsed_ms * 1000), static_cast<uint32_t>(assignment.size()),
+                                   flags};
+    uint32_t length = sizeof(header) + assignment.size() * sizeof(uint16_t);
+    out.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (int processor : assignment) {
+        uint16_t packed = processor;
+        out.append(reinterpret_cast<const char *>(&packed), sizeof(packed));
+    }
+}
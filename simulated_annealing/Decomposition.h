@@ -0,0 +1,203 @@
+#pragma once
+#include "SimulatedAnnealing.h"
+#include "LocalSearch.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+// Декомпозиция одного большого экземпляра по группам процессоров. Процессоры вместе со своими
+// работами делятся на G групп, каждая группа отжигается как самостоятельная задача на своем
+// потоке, затем межгрупповая балансировка выравнивает пары крайних процессоров (самый
+// загруженный с самым свободным и т.д.). Раунды повторяются, пока K1 уменьшается.
+// Полная матрица N×M при этом не строится: подзадачи содержат только свои работы.
+struct DecompositionConfig {
+    int groups = 4;
+    int max_rounds = 20;
+    long long group_iterations = 2000;  // итераций отжига группы за раунд
+    int rebalance_pairs = 0;            // пар крайних процессоров за раунд; 0 — по числу групп
+    int stale_rounds = 2;               // раундов без улучшения до остановки
+    unsigned int seed = 1;
+};
+
+// Назначения и K1 без полного решения: декомпозиции достаточно вектора «работа → процессор»
+inline std::vector<int> round_robin_assignment(size_t num_jobs, int num_processors) {
+    std::vector<int> assignment(num_jobs);
+    for (size_t job = 0; job < num_jobs; ++job) assignment[job] = job % num_processors;
+    return assignment;
+}
+
+inline double assignment_cost(const std::vector<uint32_t> &durations, const std::vector<int> &assignment,
+                              int num_processors) {
+    std::vector<int64_t> loads(num_processors, 0);
+    for (size_t job = 0; job < assignment.size(); ++job) loads[assignment[job]] += durations[job];
+    auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+    return static_cast<double>(*hi - *lo);
+}
+
+// Подзадача размера одной группы (работы первых процессоров, не больше max_jobs) —
+// на ней калибруется температура, с которой отжигаются группы
+inline std::shared_ptr<Solution> group_sample(const std::vector<uint32_t> &durations,
+                                              const std::vector<int> &assignment, int num_processors,
+                                              int groups, size_t max_jobs, unsigned int seed) {
+    int sample_processors = std::clamp(num_processors / std::max(1, groups), std::min(2, num_processors),
+                                       num_processors);
+    std::vector<uint32_t> sample_durations;
+    std::vector<int> sample_assignment;
+    for (size_t job = 0; job < assignment.size() && sample_durations.size() < max_jobs; ++job) {
+        if (assignment[job] >= sample_processors) continue;
+        sample_durations.push_back(durations[job]);
+        sample_assignment.push_back(assignment[job]);
+    }
+    auto sample = make_scheduling_solution(sample_durations.size(), sample_processors, sample_durations, seed);
+    sample->set_assignment(sample_assignment);
+    return sample;
+}
+
+struct DecompositionResult {
+    std::vector<int> assignment;
+    double cost = 0;
+    int rounds = 0;
+    long long iterations = 0;
+    std::vector<double> round_costs;
+};
+
+class ProcessorGroupDecomposition {
+private:
+    ThreadPool &pool;
+    Mutation &mutation;
+    TemperatureLaw &law;
+    double initial_temp;
+    DecompositionConfig config;
+
+    const std::vector<uint32_t> &durations;
+    int num_processors;
+    std::vector<int> assignment;
+    std::vector<int64_t> loads;
+    std::atomic<long long> iterations{0};
+
+    void recompute_loads() {
+        std::fill(loads.begin(), loads.end(), 0);
+        for (size_t job = 0; job < assignment.size(); ++job) loads[assignment[job]] += durations[job];
+    }
+
+    double cost() const {
+        auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+        return static_cast<double>(*hi - *lo);
+    }
+
+    std::vector<std::vector<int>> jobs_by_processor() const {
+        std::vector<std::vector<int>> jobs(num_processors);
+        for (size_t job = 0; job < assignment.size(); ++job) jobs[assignment[job]].push_back(job);
+        return jobs;
+    }
+
+    // Подзадача на наборе процессоров: их работы переназначаются внутри набора.
+    // Разные подзадачи касаются разных работ, поэтому пишут в assignment без блокировок.
+    void solve_subproblem(const std::vector<int> &processors, const std::vector<std::vector<int>> &jobs,
+                          long long iterations, unsigned int seed) {
+        std::vector<int> local_jobs;
+        std::vector<uint32_t> local_durations;
+        std::vector<int> local_assignment;
+        for (size_t local = 0; local < processors.size(); ++local) {
+            for (int job : jobs[processors[local]]) {
+                local_jobs.push_back(job);
+                local_durations.push_back(durations[job]);
+                local_assignment.push_back(local);
+            }
+        }
+        if (local_jobs.empty() || processors.size() < 2) return;
+
+        std::shared_ptr<Solution> sub = make_scheduling_solution(local_jobs.size(), processors.size(),
+                                                                 local_durations, seed);
+        dynamic_cast<SchedulingSolution &>(*sub).set_assignment(local_assignment);
+        if (iterations > 0) {
+            SimulatedAnnealing sa(sub.get(), &mutation, &law, initial_temp, seed);
+            this->iterations += sa.advance(iterations);
+            // Отжиг мог уйти в худшее состояние; берется лучшее из исходного и найденного
+            if (sa.getLocalBestSolution()->get_cost() < sub->get_cost()) sub = sa.getLocalBestSolution()->clone();
+        }
+        polish_solution(*sub);
+        std::vector<int> result = dynamic_cast<SchedulingSolution &>(*sub).get_assignment();
+        for (size_t i = 0; i < local_jobs.size(); ++i) assignment[local_jobs[i]] = processors[result[i]];
+    }
+
+    // Группы по «змейке» от самого загруженного процессора: суммарные загрузки групп близки
+    std::vector<std::vector<int>> partition(std::mt19937 &rng) const {
+        std::vector<int> order(num_processors);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return loads[a] > loads[b]; });
+        std::vector<std::vector<int>> groups(config.groups);
+        for (int i = 0; i < num_processors; ++i) {
+            int lap = i / config.groups;
+            int slot = i % config.groups;
+            groups[lap % 2 == 0 ? slot : config.groups - 1 - slot].push_back(order[i]);
+        }
+        return groups;
+    }
+
+    template <typename Task>
+    void run_parallel(size_t count, Task task) {
+        std::vector<std::future<void>> futures;
+        for (size_t i = 0; i < count; ++i) futures.push_back(pool.submit([&task, i]() { task(i); }));
+        for (auto &future : futures) future.get();
+    }
+
+public:
+    ProcessorGroupDecomposition(ThreadPool &pool, Mutation &mutation, TemperatureLaw &law, double temp,
+                                const DecompositionConfig &config, const std::vector<uint32_t> &durations,
+                                int num_processors) :
+        pool(pool), mutation(mutation), law(law), initial_temp(temp), config(config),
+        durations(durations), num_processors(num_processors), loads(num_processors) {
+        this->config.groups = std::clamp(config.groups, 1, std::max(1, num_processors / 2));
+        if (this->config.rebalance_pairs <= 0) this->config.rebalance_pairs = this->config.groups;
+        this->config.rebalance_pairs = std::min(this->config.rebalance_pairs, num_processors / 2);
+    }
+
+    DecompositionResult run(const std::vector<int> &initial_assignment) {
+        assignment = initial_assignment;
+        recompute_loads();
+        std::mt19937 rng(config.seed);
+        DecompositionResult result;
+        double best = cost();
+        std::vector<int> best_assignment = assignment;
+        int stale = 0;
+
+        for (int round = 0; round < config.max_rounds && stale < config.stale_rounds && best > 1; ++round) {
+            // Отжиг групп
+            auto groups = partition(rng);
+            auto jobs = jobs_by_processor();
+            run_parallel(groups.size(), [&](size_t g) {
+                solve_subproblem(groups[g], jobs, config.group_iterations, derive_seed(config.seed, round, g));
+            });
+            recompute_loads();
+
+            // Межгрупповая балансировка: k-й по загрузке процессор в паре с k-м с конца
+            std::vector<int> order(num_processors);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](int a, int b) { return loads[a] > loads[b]; });
+            jobs = jobs_by_processor();
+            run_parallel(config.rebalance_pairs, [&](size_t k) {
+                solve_subproblem({order[k], order[num_processors - 1 - k]}, jobs, 0, 0);
+            });
+            recompute_loads();
+
+            double current = cost();
+            result.round_costs.push_back(current);
+            result.rounds++;
+            if (current < best) {
+                best = current;
+                best_assignment = assignment;
+                stale = 0;
+            } else {
+                stale++;
+            }
+        }
+        result.assignment = best_assignment;
+        result.cost = best;
+        result.iterations = iterations.load();
+        return result;
+    }
+};
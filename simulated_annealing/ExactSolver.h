@@ -0,0 +1,207 @@
+#pragma once
+#include "Solution.h"
+#include <cstdint>
+#include <map>
+
+// Точное решение при M <= 3 динамикой по достижимым суммам на битовых множествах: добавление
+// предмета веса w — это сдвиг множества на w бит и OR, по 64 суммы за операцию.
+//   M = 2: одномерное множество сумм первого процессора; работы одной длительности
+//          склеиваются двоичным разбиением (1, 2, 4, ..., остаток), так что предметов
+//          O(число длительностей * log N), а любое количество работ класса представимо.
+//   M = 3: двумерное множество пар (s1, s2), строка на s1; третий процессор получает остаток.
+//          Предмет — одна работа: двоичное разбиение не позволяет разделить класс на две части.
+// Для восстановления решения у каждой суммы хранится номер предмета, впервые сделавшего ее
+// достижимой: сумма без этого предмета была достижима раньше, так что путь назад однозначен.
+// Память под эти номера ограничивает применимость: (T+1) ячеек при M = 2, (T+1)^2 при M = 3.
+constexpr uint64_t EXACT_MAX_CELLS = uint64_t(1) << 25;
+
+class BitsetSubsetDP {
+private:
+    static constexpr uint16_t UNSET = 0xFFFF;
+
+    struct Item {
+        uint32_t duration;
+        uint32_t count;   // работ в предмете
+        uint64_t weight;
+    };
+
+    const std::vector<uint32_t> &durations;
+    int num_processors;
+    uint64_t total = 0;
+    std::vector<Item> items;
+
+    static bool test(const std::vector<uint64_t> &bits, uint64_t i) {
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    // base |= (base << shift) | extra по словам, от старших к младшим, чтобы читать еще не
+    // измененные слова; для каждой впервые появившейся суммы вызывается on_new
+    template <typename OnNew>
+    static void shift_or(uint64_t *base, size_t words, uint64_t shift, const uint64_t *extra, OnNew on_new) {
+        size_t word_shift = shift >> 6;
+        unsigned bit_shift = shift & 63;
+        for (size_t i = words; i-- > 0;) {
+            uint64_t shifted = 0;
+            if (i >= word_shift) {
+                shifted = base[i - word_shift] << bit_shift;
+                if (bit_shift && i > word_shift) shifted |= base[i - word_shift - 1] >> (64 - bit_shift);
+            }
+            uint64_t fresh = (shifted | (extra ? extra[i] : 0)) & ~base[i];
+            base[i] |= fresh;
+            while (fresh) {
+                on_new((i << 6) + __builtin_ctzll(fresh));
+                fresh &= fresh - 1;
+            }
+        }
+    }
+
+    // Работы по классам длительности: для каждого класса — номера работ
+    std::map<uint32_t, std::vector<int>> jobs_by_duration() const {
+        std::map<uint32_t, std::vector<int>> classes;
+        for (size_t job = 0; job < durations.size(); ++job) classes[durations[job]].push_back(job);
+        return classes;
+    }
+
+    // Назначает count очередных работ длительности duration на processor
+    static void assign_counts(std::map<uint32_t, std::vector<int>> &classes, std::map<uint32_t, size_t> &cursor,
+                              uint32_t duration, uint32_t count, int processor, std::vector<int> &assignment) {
+        auto &jobs = classes[duration];
+        size_t &next = cursor[duration];
+        for (uint32_t k = 0; k < count; ++k) assignment[jobs[next++]] = processor;
+    }
+
+    std::vector<int> solve_two() {
+        auto classes = jobs_by_duration();
+        for (const auto &[duration, jobs] : classes) {
+            if (duration == 0) continue;
+            uint32_t left = jobs.size();
+            for (uint32_t piece = 1; left > 0; piece <<= 1) {
+                uint32_t take = std::min(piece, left);
+                items.push_back({duration, take, static_cast<uint64_t>(duration) * take});
+                left -= take;
+            }
+        }
+        if (items.size() >= UNSET) throw std::runtime_error("Exact solver: too many items");
+
+        size_t words = total / 64 + 1;
+        std::vector<uint64_t> bits(words, 0);
+        std::vector<uint16_t> parent(total + 1, UNSET);
+        bits[0] = 1;
+        uint64_t prefix = 0;  // сумма уже добавленных предметов: старшие слова еще пусты
+        for (size_t k = 0; k < items.size(); ++k) {
+            prefix += items[k].weight;
+            shift_or(bits.data(), prefix / 64 + 1, items[k].weight, nullptr, [&](uint64_t s) { parent[s] = k; });
+        }
+
+        // Ближайшая к T/2 снизу достижимая сумма дает минимальный K1 = T - 2s
+        uint64_t s = total / 2;
+        while (!test(bits, s)) --s;
+
+        std::vector<int> assignment(durations.size(), 1);
+        std::map<uint32_t, size_t> cursor;
+        for (auto &[duration, jobs] : classes) {
+            if (duration == 0) assign_counts(classes, cursor, 0, jobs.size(), 0, assignment);
+        }
+        while (s > 0) {
+            const Item &item = items[parent[s]];
+            assign_counts(classes, cursor, item.duration, item.count, 0, assignment);
+            s -= item.weight;
+        }
+        return assignment;
+    }
+
+    std::vector<int> solve_three() {
+        auto classes = jobs_by_duration();
+        for (const auto &[duration, jobs] : classes) {
+            if (duration == 0) continue;
+            for (size_t k = 0; k < jobs.size(); ++k) items.push_back({duration, 1, duration});
+        }
+        if (items.size() >= UNSET) throw std::runtime_error("Exact solver: too many items");
+
+        uint64_t side = total + 1;
+        size_t words = side / 64 + 1;
+        std::vector<uint64_t> bits(side * words, 0);
+        std::vector<uint16_t> parent(side * side, UNSET);
+        bits[0] = 1;
+        uint64_t prefix = 0;
+        for (size_t k = 0; k < items.size(); ++k) {
+            uint64_t w = items[k].weight;
+            prefix += w;
+            size_t active = prefix / 64 + 1;
+            // Строки по убыванию s1: строка s1 - w еще не изменена этим предметом
+            for (uint64_t s1 = prefix + 1; s1-- > 0;) {
+                const uint64_t *from_first = s1 >= w ? &bits[(s1 - w) * words] : nullptr;
+                shift_or(&bits[s1 * words], active, w, from_first, [&](uint64_t s2) { parent[s1 * side + s2] = k; });
+            }
+        }
+
+        // Лучшая пара (s1, s2) по K1 трех загрузок
+        uint64_t best_s1 = 0, best_s2 = 0;
+        uint64_t best_cost = UINT64_MAX;
+        for (uint64_t s1 = 0; s1 <= total; ++s1) {
+            for (uint64_t s2 = 0; s1 + s2 <= total; ++s2) {
+                if (!test(bits, s1 * words * 64 + s2)) continue;
+                uint64_t s3 = total - s1 - s2;
+                uint64_t cost = std::max({s1, s2, s3}) - std::min({s1, s2, s3});
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_s1 = s1;
+                    best_s2 = s2;
+                }
+            }
+        }
+
+        // Ячейка достижима без предмета k, если ее впервые достиг более ранний предмет
+        auto reached_before = [&](uint64_t s1, uint64_t s2, size_t k) {
+            if (s1 == 0 && s2 == 0) return true;
+            uint16_t p = parent[s1 * side + s2];
+            return p != UNSET && p < k;
+        };
+        std::vector<int> assignment(durations.size(), 2);
+        std::map<uint32_t, size_t> cursor;
+        for (auto &[duration, jobs] : classes) {
+            if (duration == 0) assign_counts(classes, cursor, 0, jobs.size(), 2, assignment);
+        }
+        uint64_t s1 = best_s1, s2 = best_s2;
+        while (s1 > 0 || s2 > 0) {
+            size_t k = parent[s1 * side + s2];
+            const Item &item = items[k];
+            if (s1 >= item.weight && reached_before(s1 - item.weight, s2, k)) {
+                assign_counts(classes, cursor, item.duration, 1, 0, assignment);
+                s1 -= item.weight;
+            } else {
+                assign_counts(classes, cursor, item.duration, 1, 1, assignment);
+                s2 -= item.weight;
+            }
+        }
+        return assignment;
+    }
+
+public:
+    BitsetSubsetDP(const std::vector<uint32_t> &durations, int num_processors) :
+        durations(durations), num_processors(num_processors) {
+        for (uint32_t d : durations) total += d;
+    }
+
+    static bool applicable(const std::vector<uint32_t> &durations, int num_processors) {
+        if (num_processors < 1 || num_processors > 3 || durations.empty()) return false;
+        uint64_t total = 0;
+        for (uint32_t d : durations) total += d;
+        uint64_t cells = num_processors == 3 ? (total + 1) * (total + 1) : total + 1;
+        return num_processors == 1 || cells <= EXACT_MAX_CELLS;
+    }
+
+    std::vector<int> solve() {
+        if (num_processors == 1) return std::vector<int>(durations.size(), 0);
+        return num_processors == 2 ? solve_two() : solve_three();
+    }
+};
+
+// Точное решение, если экземпляр подходит по размеру; иначе nullptr и решает отжиг
+inline std::shared_ptr<SchedulingSolution> solve_exact(const std::vector<uint32_t> &durations, int num_processors,
+                                                       unsigned int seed) {
+    if (!BitsetSubsetDP::applicable(durations, num_processors)) return nullptr;
+    auto solution = make_scheduling_solution(durations.size(), num_processors, durations, seed);
+    solution->set_assignment(BitsetSubsetDP(durations, num_processors).solve());
+    return solution;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Дешевые признаки экземпляра и выбор решателя по ним. Признаки считаются за O(N):
+// один проход дает N, сумму, min/max и гистограмму по степеням двойки, второй — жадное
+// расписание (грубый LPT: корзины гистограммы от крупных к мелким, внутри корзины — порядок
+// входа, каждая работа на наименее загруженный процессор, O(log M) на работу).
+// Решатель берется из таблицы правил solver_rules.csv, которую пишет experiment_runner
+// по результатам сетки; каждое решение дописывается в журнал для последующего разбора.
+constexpr int DURATION_BUCKETS = 33;  // 0 — нулевые работы, k — длительности [2^(k-1), 2^k)
+
+struct InstanceFeatures {
+    int num_jobs = 0;
+    int num_processors = 0;
+    uint64_t total_work = 0;
+    uint32_t min_duration = 0;
+    uint32_t max_duration = 0;
+    double mean_duration = 0;
+    std::array<uint32_t, DURATION_BUCKETS> histogram = {};
+    int64_t lower_bound = 0;   // K1 >= max(ceil(T/M), самая длинная работа) - floor(T/M); при N < M минимум 0
+    int64_t greedy_cost = 0;   // K1 жадного расписания
+    int64_t greedy_gap = 0;    // greedy_cost - lower_bound; 0 — жадное расписание оптимально
+    std::vector<int> greedy_assignment;
+};
+
+inline int duration_bucket(uint32_t duration) {
+    return duration == 0 ? 0 : 32 - __builtin_clz(duration);
+}
+
+inline InstanceFeatures analyze_instance(const std::vector<uint32_t> &durations, int num_processors) {
+    if (num_processors < 1) throw std::runtime_error("Instance analyzer: need at least one processor");
+    InstanceFeatures f;
+    f.num_jobs = durations.size();
+    f.num_processors = num_processors;
+    f.min_duration = durations.empty() ? 0 : UINT32_MAX;
+    for (uint32_t d : durations) {
+        f.total_work += d;
+        f.min_duration = std::min(f.min_duration, d);
+        f.max_duration = std::max(f.max_duration, d);
+        f.histogram[duration_bucket(d)]++;
+    }
+    f.mean_duration = f.num_jobs ? static_cast<double>(f.total_work) / f.num_jobs : 0;
+    uint64_t floor_share = f.num_jobs < num_processors ? 0 : f.total_work / num_processors;
+    uint64_t ceil_share = (f.total_work + num_processors - 1) / num_processors;
+    f.lower_bound = static_cast<int64_t>(std::max<uint64_t>(ceil_share, f.max_duration) - floor_share);
+
+    // Начала корзин в порядке убывания длительностей — сортировка подсчетом по корзинам
+    std::array<size_t, DURATION_BUCKETS> start = {};
+    for (int b = DURATION_BUCKETS - 2; b >= 0; --b) start[b] = start[b + 1] + f.histogram[b + 1];
+    std::vector<int> order(durations.size());
+    for (size_t job = 0; job < durations.size(); ++job) order[start[duration_bucket(durations[job])]++] = job;
+
+    using Entry = std::pair<uint64_t, int>;  // (загрузка, процессор)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> least;
+    for (int p = 0; p < num_processors; ++p) least.push({0, p});
+    f.greedy_assignment.resize(durations.size());
+    std::vector<uint64_t> loads(num_processors, 0);
+    for (int job : order) {
+        auto [load, p] = least.top();
+        least.pop();
+        f.greedy_assignment[job] = p;
+        loads[p] = load + durations[job];
+        least.push({loads[p], p});
+    }
+    auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+    f.greedy_cost = static_cast<int64_t>(*hi - *lo);
+    f.greedy_gap = f.greedy_cost - f.lower_bound;
+    return f;
+}
+
+// Строка таблицы: условия (0 — без ограничения) и выбранная конфигурация. Правила проверяются
+// по порядку, срабатывает первое подходящее.
+//   MaxJobs,MaxProcessors,MaxDuration,Engine,Law,Threads,Budget,Source
+struct SolverRule {
+    int max_jobs = 0;
+    int max_processors = 0;
+    uint32_t max_duration = 0;
+    std::string engine = "sa";
+    std::string law = "cauchy";
+    int threads = 0;            // 0 — по числу ядер
+    double budget = 0;          // секунды на поиск, 0 — без ограничения
+    std::string source;         // откуда взято правило: файл результатов, дата
+
+    bool matches(const InstanceFeatures &f) const {
+        return (max_jobs == 0 || f.num_jobs <= max_jobs) &&
+               (max_processors == 0 || f.num_processors <= max_processors) &&
+               (max_duration == 0 || f.max_duration <= max_duration);
+    }
+};
+
+struct SolverChoice {
+    std::string engine;
+    std::string law;
+    int threads = 1;
+    double budget = 0;
+    std::string rule;  // какое правило сработало: "greedy", "default" или "rules:<номер правила>"
+    std::string source;
+};
+
+inline std::vector<SolverRule> load_solver_rules(const std::string &filename) {
+    std::vector<SolverRule> rules;
+    std::ifstream file(filename);
+    if (!file.is_open()) return rules;  // таблицы еще нет — работает правило по умолчанию
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line_number == 1) continue;  // заголовок
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() < 7) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": expected at least 7 columns");
+        }
+        SolverRule rule;
+        rule.max_jobs = std::stoi(fields[0]);
+        rule.max_processors = std::stoi(fields[1]);
+        rule.max_duration = std::stoul(fields[2]);
+        rule.engine = fields[3];
+        rule.law = fields[4];
+        rule.threads = std::stoi(fields[5]);
+        rule.budget = std::stod(fields[6]);
+        if (fields.size() > 7) rule.source = fields[7];
+        rules.push_back(rule);
+    }
+    return rules;
+}
+
+// Если жадное расписание уже достигает нижней оценки, поиск не нужен. Без подходящего правила —
+// Коши на всех ядрах: на тяжелых входах из find_heavy_inputs он в разы быстрее Больцмана.
+inline SolverChoice choose_solver(const InstanceFeatures &f, const std::vector<SolverRule> &rules) {
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    if (f.greedy_gap == 0) return {"greedy", "none", 1, 0, "greedy", "lower bound"};
+    for (size_t i = 0; i < rules.size(); ++i) {
+        if (!rules[i].matches(f)) continue;
+        int threads = rules[i].threads > 0 ? std::min(rules[i].threads, cores) : cores;
+        return {rules[i].engine, rules[i].law, threads, rules[i].budget, "rules:" + std::to_string(i + 1),
+                rules[i].source};
+    }
+    return {"sa", "cauchy", cores, 0, "default", "built-in"};
+}
+
+// Журнал решений: признаки, сработавшее правило и выбор — по строке на запуск
+inline void log_solver_decision(const std::string &filename, const InstanceFeatures &f, const SolverChoice &choice) {
+    bool fresh = !std::ifstream(filename).good();
+    std::ofstream log(filename, std::ios::app);
+    if (!log.is_open()) throw std::runtime_error("Unable to open decision log " + filename);
+    if (fresh) {
+        log << "Timestamp,Jobs,Processors,TotalWork,MinDuration,MaxDuration,LowerBound,GreedyCost,GreedyGap,"
+               "Rule,Source,Engine,Law,Threads,Budget\n";
+    }
+    log << std::time(nullptr) << "," << f.num_jobs << "," << f.num_processors << "," << f.total_work << ","
+        << f.min_duration << "," << f.max_duration << "," << f.lower_bound << "," << f.greedy_cost << ","
+        << f.greedy_gap << "," << choice.rule << "," << choice.source << "," << choice.engine << "," << choice.law << ","
+        << choice.threads << "," << choice.budget << "\n";
+}
+
+inline void print_instance_features(std::ostream &out, const InstanceFeatures &f) {
+    out << "Instance: " << f.num_jobs << " jobs, " << f.num_processors << " processors, total work "
+        << f.total_work << ", durations " << f.min_duration << ".." << f.max_duration << " (mean "
+        << f.mean_duration << ")\n";
+    out << "Нижняя оценка K1: " << f.lower_bound << ", жадное расписание: " << f.greedy_cost
+        << " (разрыв " << f.greedy_gap << ")\n";
+}
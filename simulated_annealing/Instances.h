@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+// Экземпляр нужного размера в памяти: первые num_jobs работ базового набора, а если их не
+// хватает — базовый набор, дополненный случайными длительностями из того же диапазона
+// (зерно фиксировано, так что у одной ячейки сетки всегда один и тот же экземпляр)
+// Зерно дополнения по умолчанию, общее для всех драйверов: одна ячейка сетки (N, M) дает один
+// и тот же экземпляр и в main_1_exp, и в experiment_runner; зерно запуска влияет только на отжиг
+constexpr unsigned int DEFAULT_INSTANCE_SEED = 7;
+
+inline std::vector<uint32_t> make_instance(const std::vector<uint32_t> &base, int num_jobs, unsigned int seed) {
+    if (static_cast<size_t>(num_jobs) <= base.size()) {
+        return std::vector<uint32_t>(base.begin(), base.begin() + num_jobs);
+    }
+    uint32_t low = 1, high = 255;
+    if (!base.empty()) {
+        auto [min_it, max_it] = std::minmax_element(base.begin(), base.end());
+        low = *min_it;
+        high = *max_it;
+    }
+    std::vector<uint32_t> instance(base);
+    instance.reserve(num_jobs);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> duration(low, high);
+    while (instance.size() < static_cast<size_t>(num_jobs)) {
+        instance.push_back(duration(rng));
+    }
+    return instance;
+}
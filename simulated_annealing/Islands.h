@@ -0,0 +1,205 @@
+#pragma once
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Экземпляр задачи в разделяемой памяти POSIX: заголовок и следом N длительностей (uint32).
+// Координатор создает сегмент, рабочие процессы отображают его только на чтение.
+struct SharedInstanceHeader {
+    uint32_t magic;
+    uint32_t num_jobs;
+    uint32_t num_processors;
+    uint32_t reserved;
+};
+
+constexpr uint32_t SHARED_INSTANCE_MAGIC = 0x53414931;  // "SAI1"
+
+class SharedInstance {
+private:
+    std::string name;
+    void *data = MAP_FAILED;
+    size_t size = 0;
+    bool owner = false;
+
+public:
+    // Создание сегмента координатором
+    SharedInstance(const std::string &shm_name, const std::vector<uint32_t> &durations, int num_processors) :
+        name(shm_name), size(sizeof(SharedInstanceHeader) + durations.size() * sizeof(uint32_t)), owner(true) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open " + name + ": " + std::strerror(errno));
+        if (ftruncate(fd, size) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ftruncate " + name + ": " + std::strerror(errno));
+        }
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::runtime_error("mmap " + name + ": " + std::strerror(errno));
+        }
+        auto *header = static_cast<SharedInstanceHeader *>(data);
+        header->magic = SHARED_INSTANCE_MAGIC;
+        header->num_jobs = durations.size();
+        header->num_processors = num_processors;
+        header->reserved = 0;
+        std::memcpy(header + 1, durations.data(), durations.size() * sizeof(uint32_t));
+    }
+
+    // Подключение рабочего процесса к существующему сегменту
+    explicit SharedInstance(const std::string &shm_name) : name(shm_name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("shm_open " + name + ": " + std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedInstanceHeader)) {
+            close(fd);
+            throw std::runtime_error("Shared instance " + name + " is truncated");
+        }
+        size = st.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) throw std::runtime_error("mmap " + name + ": " + std::strerror(errno));
+        if (header().magic != SHARED_INSTANCE_MAGIC ||
+            size < sizeof(SharedInstanceHeader) + header().num_jobs * sizeof(uint32_t)) {
+            munmap(data, size);
+            throw std::runtime_error("Shared instance " + name + " has invalid header");
+        }
+    }
+
+    ~SharedInstance() {
+        if (data != MAP_FAILED) munmap(data, size);
+        if (owner) shm_unlink(name.c_str());
+    }
+
+    SharedInstance(const SharedInstance &) = delete;
+    SharedInstance &operator=(const SharedInstance &) = delete;
+
+    const SharedInstanceHeader &header() const {
+        return *static_cast<const SharedInstanceHeader *>(data);
+    }
+
+    const uint32_t *durations() const {
+        return reinterpret_cast<const uint32_t *>(&header() + 1);
+    }
+};
+
+// Протокол обмена: заголовок фиксированной длины и count номеров процессоров (uint16).
+// count = 0 в ответе BEST означает «твое решение и есть глобальный рекорд».
+enum IslandMessageType : uint32_t {
+    ISLAND_HELLO = 1,
+    ISLAND_BEST = 2,
+    ISLAND_STOP = 3
+};
+
+struct IslandMessageHeader {
+    uint32_t type;
+    uint32_t worker;
+    uint64_t cost;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct IslandMessage {
+    IslandMessageHeader header;
+    std::vector<uint16_t> assignment;
+};
+
+inline bool write_all(int fd, const void *buffer, size_t length) {
+    const char *ptr = static_cast<const char *>(buffer);
+    while (length > 0) {
+        ssize_t written = write(fd, ptr, length);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        ptr += written;
+        length -= written;
+    }
+    return true;
+}
+
+inline bool read_all(int fd, void *buffer, size_t length) {
+    char *ptr = static_cast<char *>(buffer);
+    while (length > 0) {
+        ssize_t got = read(fd, ptr, length);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        ptr += got;
+        length -= got;
+    }
+    return true;
+}
+
+inline bool send_message(int fd, uint32_t type, uint32_t worker, uint64_t cost,
+                         const std::vector<uint16_t> &assignment = {}) {
+    IslandMessageHeader header = {type, worker, cost, static_cast<uint32_t>(assignment.size()), 0};
+    if (!write_all(fd, &header, sizeof(header))) return false;
+    return assignment.empty() || write_all(fd, assignment.data(), assignment.size() * sizeof(uint16_t));
+}
+
+inline bool receive_message(int fd, IslandMessage &message, uint32_t max_count) {
+    if (!read_all(fd, &message.header, sizeof(message.header))) return false;
+    if (message.header.count > max_count) return false;
+    message.assignment.resize(message.header.count);
+    return message.header.count == 0 ||
+           read_all(fd, message.assignment.data(), message.header.count * sizeof(uint16_t));
+}
+
+inline sockaddr_un make_socket_address(const std::string &path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    return address;
+}
+
+inline int listen_unix(const std::string &path, int backlog) {
+    sockaddr_un address = make_socket_address(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(fd, backlog) != 0) {
+        close(fd);
+        throw std::runtime_error("bind/listen " + path + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+inline int connect_unix(const std::string &path) {
+    sockaddr_un address = make_socket_address(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error("connect " + path + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+// Больше процессоров номер в uint16 не вместит; координатор отказывается от таких экземпляров
+constexpr int ISLAND_MAX_PROCESSORS = 65536;
+
+inline std::vector<uint16_t> pack_assignment(const std::vector<int> &assignment) {
+    return std::vector<uint16_t>(assignment.begin(), assignment.end());
+}
+
+inline std::vector<int> unpack_assignment(const std::vector<uint16_t> &assignment) {
+    return std::vector<int>(assignment.begin(), assignment.end());
+}
+
+inline bool valid_assignment(const std::vector<uint16_t> &assignment, int num_processors) {
+    for (uint16_t processor : assignment) {
+        if (processor >= num_processors) return false;
+    }
+    return true;
+}
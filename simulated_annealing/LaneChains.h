@@ -0,0 +1,246 @@
+#pragma once
+#include "CoroutineChains.h"
+#include "LoadKernels.h"
+
+// Мультистарт для малых M: цепочки упакованы блоками по LANES в векторные дорожки.
+// Загрузки блока лежат как [процессор][дорожка], так что K1 всех дорожек после хода — это
+// min/max по M строкам, по одной векторной операции на строку. Дорожки идут в ногу:
+// общий номер итерации и температура, расходятся только выбранные работы и процессоры.
+// Выбор хода и откат — скалярные на дорожку (индексы у всех разные), K1 и проверка
+// «ход не ухудшает» — векторные; экспонента Метрополиса считается только у ухудшивших дорожек.
+constexpr int LANES = 16;
+
+namespace lane_kernels {
+
+// new_cost[l] = max_p loads[p][l] - min_p loads[p][l]; возвращает маску дорожек, где new_cost > cost
+inline uint32_t spread_scalar(const int32_t *loads, int rows, const int32_t *cost, int32_t *new_cost) {
+    uint32_t uphill = 0;
+    for (int l = 0; l < LANES; ++l) {
+        int32_t lo = loads[l], hi = loads[l];
+        for (int p = 1; p < rows; ++p) {
+            lo = std::min(lo, loads[p * LANES + l]);
+            hi = std::max(hi, loads[p * LANES + l]);
+        }
+        new_cost[l] = hi - lo;
+        if (new_cost[l] > cost[l]) uphill |= 1u << l;
+    }
+    return uphill;
+}
+
+#ifdef LOAD_KERNELS_X86
+
+__attribute__((target("avx2")))
+inline uint32_t spread_avx2(const int32_t *loads, int rows, const int32_t *cost, int32_t *new_cost) {
+    __m256i lo0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads));
+    __m256i lo1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads + 8));
+    __m256i hi0 = lo0, hi1 = lo1;
+    for (int p = 1; p < rows; ++p) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads + p * LANES));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads + p * LANES + 8));
+        lo0 = _mm256_min_epi32(lo0, v0);
+        lo1 = _mm256_min_epi32(lo1, v1);
+        hi0 = _mm256_max_epi32(hi0, v0);
+        hi1 = _mm256_max_epi32(hi1, v1);
+    }
+    __m256i s0 = _mm256_sub_epi32(hi0, lo0);
+    __m256i s1 = _mm256_sub_epi32(hi1, lo1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(new_cost), s0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(new_cost + 8), s1);
+    __m256i c0 = _mm256_cmpgt_epi32(s0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cost)));
+    __m256i c1 = _mm256_cmpgt_epi32(s1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cost + 8)));
+    uint32_t m0 = _mm256_movemask_ps(_mm256_castsi256_ps(c0));
+    uint32_t m1 = _mm256_movemask_ps(_mm256_castsi256_ps(c1));
+    return m0 | (m1 << 8);
+}
+
+__attribute__((target("avx512f")))
+inline uint32_t spread_avx512(const int32_t *loads, int rows, const int32_t *cost, int32_t *new_cost) {
+    __m512i lo = _mm512_loadu_si512(loads);
+    __m512i hi = lo;
+    for (int p = 1; p < rows; ++p) {
+        __m512i v = _mm512_loadu_si512(loads + p * LANES);
+        lo = _mm512_min_epi32(lo, v);
+        hi = _mm512_max_epi32(hi, v);
+    }
+    __m512i spread = _mm512_sub_epi32(hi, lo);
+    _mm512_storeu_si512(new_cost, spread);
+    return _mm512_cmpgt_epi32_mask(spread, _mm512_loadu_si512(cost));
+}
+
+#endif
+
+using SpreadKernel = uint32_t (*)(const int32_t *, int, const int32_t *, int32_t *);
+
+inline SpreadKernel select_spread() {
+#ifdef LOAD_KERNELS_X86
+    switch (load_kernels::active_isa()) {
+        case load_kernels::Isa::AVX512: return spread_avx512;
+        case load_kernels::Isa::AVX2: return spread_avx2;
+        default: break;
+    }
+#endif
+    return spread_scalar;
+}
+
+}  // namespace lane_kernels
+
+struct LaneConfig {
+    int chains = 1024;                    // округляется вверх до кратного LANES
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    long long iterations_per_chain = 2000;
+    int max_no_improvement = 500;         // блок останавливается, когда застряли все дорожки
+    unsigned int seed = 1;
+};
+
+struct LaneResult {
+    std::shared_ptr<SchedulingSolution> best;
+    long long iterations = 0;  // сумма по всем цепочкам
+    int chains = 0;
+    double seconds = 0;
+};
+
+class LaneChainPool {
+private:
+    // Блок из LANES цепочек; все массивы — структура массивов
+    struct Block {
+        std::vector<int32_t> loads;             // [processor][lane]
+        std::vector<uint16_t> assignment;       // [lane][job]
+        std::vector<uint16_t> best_assignment;  // [lane][job]
+        int32_t cost[LANES];
+        int32_t best_cost[LANES];
+        int no_improvement[LANES];
+        SmallRng rng[LANES];
+    };
+
+    const LaneConfig config;
+    const TemperatureLaw &law;
+    std::vector<uint32_t> durations;
+    int num_jobs;
+    int num_processors;
+    lane_kernels::SpreadKernel spread = lane_kernels::select_spread();
+
+    std::mutex best_mutex;
+    int64_t best_cost = INT64_MAX;
+    std::vector<uint16_t> best_assignment;
+    std::atomic<long long> total_iterations{0};
+
+    void init_block(Block &block, int block_index) {
+        block.loads.assign(static_cast<size_t>(num_processors) * LANES, 0);
+        block.assignment.resize(static_cast<size_t>(LANES) * num_jobs);
+        for (int l = 0; l < LANES; ++l) {
+            block.rng[l].state = (static_cast<uint64_t>(config.seed) << 32) ^
+                                 ((block_index * LANES + l) * 0x632be59bd9b4e019ULL);
+            uint16_t *assignment = &block.assignment[static_cast<size_t>(l) * num_jobs];
+            for (int job = 0; job < num_jobs; ++job) {
+                assignment[job] = block.rng[l].below(num_processors);
+                block.loads[assignment[job] * LANES + l] += durations[job];
+            }
+            block.no_improvement[l] = 0;
+        }
+        int32_t zero[LANES] = {};
+        spread(block.loads.data(), num_processors, zero, block.cost);
+        std::copy(block.cost, block.cost + LANES, block.best_cost);
+        block.best_assignment = block.assignment;
+    }
+
+    void run_block(int block_index) {
+        Block block;
+        init_block(block, block_index);
+        int32_t new_cost[LANES];
+        int job[LANES], from[LANES], to[LANES];
+        long long iter = 0;
+        for (; iter < config.iterations_per_chain; ++iter) {
+            bool all_stalled = true;
+            for (int l = 0; l < LANES; ++l) all_stalled &= block.no_improvement[l] >= config.max_no_improvement;
+            if (all_stalled) break;
+
+            for (int l = 0; l < LANES; ++l) {
+                job[l] = block.rng[l].below(num_jobs);
+                from[l] = block.assignment[static_cast<size_t>(l) * num_jobs + job[l]];
+                to[l] = block.rng[l].below(num_processors - 1);
+                if (to[l] >= from[l]) to[l]++;
+                block.loads[from[l] * LANES + l] -= durations[job[l]];
+                block.loads[to[l] * LANES + l] += durations[job[l]];
+            }
+            uint32_t uphill = spread(block.loads.data(), num_processors, block.cost, new_cost);
+            double temperature = law.get_next_temperature(iter);
+
+            for (int l = 0; l < LANES; ++l) {
+                bool accepted = true;
+                if (uphill >> l & 1) {
+                    accepted = std::exp(-(new_cost[l] - block.cost[l]) / temperature) >= block.rng[l].unit();
+                }
+                if (!accepted) {
+                    block.loads[from[l] * LANES + l] += durations[job[l]];
+                    block.loads[to[l] * LANES + l] -= durations[job[l]];
+                    block.no_improvement[l]++;
+                    continue;
+                }
+                uint16_t *assignment = &block.assignment[static_cast<size_t>(l) * num_jobs];
+                assignment[job[l]] = to[l];
+                block.cost[l] = new_cost[l];
+                if (new_cost[l] < block.best_cost[l]) {
+                    block.best_cost[l] = new_cost[l];
+                    block.no_improvement[l] = 0;
+                    std::copy(assignment, assignment + num_jobs,
+                              &block.best_assignment[static_cast<size_t>(l) * num_jobs]);
+                } else {
+                    block.no_improvement[l]++;
+                }
+            }
+        }
+        total_iterations += iter * LANES;
+
+        int winner = std::min_element(block.best_cost, block.best_cost + LANES) - block.best_cost;
+        std::lock_guard<std::mutex> lock(best_mutex);
+        if (block.best_cost[winner] < best_cost) {
+            best_cost = block.best_cost[winner];
+            auto first = block.best_assignment.begin() + static_cast<size_t>(winner) * num_jobs;
+            best_assignment.assign(first, first + num_jobs);
+        }
+    }
+
+public:
+    LaneChainPool(const SchedulingSolution &instance, const TemperatureLaw &law, const LaneConfig &config) :
+        config(config), law(law), durations(instance.get_job_times()),
+        num_jobs(instance.get_num_jobs()), num_processors(instance.get_num_processors()) {
+        if (num_processors < 2 || num_processors > 65536) {
+            throw std::runtime_error("Lane chains need 2..65536 processors");
+        }
+        if (instance.get_total_load() > INT32_MAX) {
+            throw std::runtime_error("Lane chains keep int32 loads; total load is too large");
+        }
+        if (dynamic_cast<const AdaptiveLaw *>(&law)) {
+            throw std::runtime_error("Lane chains share one stateless law; adaptive is not supported");
+        }
+    }
+
+    LaneResult run() {
+        auto start = std::chrono::steady_clock::now();
+        int blocks = (config.chains + LANES - 1) / LANES;
+        std::atomic<int> next_block{0};
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(config.workers);
+        for (int w = 0; w < config.workers; ++w) {
+            threads.emplace_back([&, w]() {
+                try {
+                    for (int b = next_block++; b < blocks; b = next_block++) run_block(b);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        for (auto &error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        LaneResult result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.iterations = total_iterations.load();
+        result.chains = blocks * LANES;
+        result.best = make_scheduling_solution(num_jobs, num_processors, durations, config.seed);
+        result.best->set_assignment(std::vector<int>(best_assignment.begin(), best_assignment.end()));
+        return result;
+    }
+};
@@ -0,0 +1,312 @@
+#pragma once
+#include "SimulatedAnnealing.h"
+#include "ExactSolver.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Поиск в больших окрестностях: ход разрушает структурированное подмножество — все работы
+// нескольких процессоров — и заново раскладывает их по этим же процессорам. Остальные процессоры
+// не меняются, так что ход сдвигает сразу тысячи работ там, где перенос одной работы почти
+// ничего не дает. Результат принимается по критерию отжига.
+// Операторы разрушения (k выбирается случайно из 1..config.k):
+//   extremes — k самых загруженных и k самых свободных процессоров, жадная починка;
+//   random   — самый загруженный и 2k-1 случайных, жадная починка;
+//   pair     — самый загруженный и один случайный, точная починка динамикой ExactSolver.h
+//              (если сумма длительностей пары укладывается в EXACT_MAX_CELLS), иначе жадная.
+// Жадная починка — LPT: работы по убыванию длительности, каждая на наименее загруженный процессор
+// подмножества; при равных длительностях порядок случайный, чтобы повтор хода давал другую раскладку.
+struct LnsConfig {
+    std::vector<std::string> operators = {"extremes", "random", "pair"};  // поток i берет operators[i % size]
+    int k = 2;
+    long long slice_iterations = 50;    // ходов между обменами рекордом в параллельном режиме
+    long long max_iterations = 100000;  // на цепочку
+    int max_no_improvement = 200;       // ходов без рекорда цепочки до перезапуска от общего рекорда
+    double seconds = 0;                 // 0 — без ограничения по времени
+    unsigned int seed = 1;
+};
+
+class LnsChain : public SearchEngine {
+private:
+    LnsConfig config;
+    std::string destroy;
+    std::shared_ptr<TemperatureLaw> law;
+    double temperature;
+    std::mt19937 rng;
+
+    std::shared_ptr<SchedulingSolution> solution;
+    std::vector<uint32_t> durations;
+    std::vector<std::vector<int>> jobs_on;  // работы каждого процессора
+    double cost = 0;
+    double lower_bound = 0;
+    // Рекорд — текущее решение без ходов журнала, как в SimulatedAnnealing
+    mutable std::shared_ptr<Solution> best_solution;
+    double best_cost = 0;
+    long long iterations = 0;
+    long long accepted = 0;
+    int iter = 0;
+    int no_improvement = 0;
+
+    void materialize_best() const {
+        auto best = solution->clone();
+        best->rollback(0);
+        best->set_journaling(false);
+        best_solution = best;
+        solution->clear_journal();
+    }
+
+    std::vector<int> processors_by_load() const {
+        std::vector<int> order(jobs_on.size());
+        for (size_t p = 0; p < order.size(); ++p) order[p] = p;
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return solution->get_processor_load(a) > solution->get_processor_load(b);
+        });
+        return order;
+    }
+
+    // Разрушаемые процессоры, без повторов
+    std::vector<int> choose_processors() {
+        int m = jobs_on.size();
+        int k = std::uniform_int_distribution<int>(1, config.k)(rng);
+        std::vector<int> chosen;
+        if (destroy == "extremes") {
+            std::vector<int> order = processors_by_load();
+            k = std::min(k, m / 2);
+            chosen.assign(order.begin(), order.begin() + k);
+            chosen.insert(chosen.end(), order.end() - k, order.end());
+            return chosen;
+        }
+        int size = destroy == "pair" ? 2 : std::min(2 * k, m);
+        std::vector<char> taken(m, 0);
+        chosen.push_back(solution->get_most_loaded_processor());
+        taken[chosen[0]] = 1;
+        std::uniform_int_distribution<int> pick(0, m - 1);
+        while (static_cast<int>(chosen.size()) < size) {
+            int p = pick(rng);
+            if (!taken[p]) {
+                taken[p] = 1;
+                chosen.push_back(p);
+            }
+        }
+        return chosen;
+    }
+
+    // target[i] — номер процессора в chosen для работы removed[i]
+    std::vector<int> greedy_repair(const std::vector<int> &removed, int parts) {
+        std::vector<int> order(removed.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return durations[removed[a]] > durations[removed[b]];
+        });
+        std::vector<int64_t> loads(parts, 0);
+        std::vector<int> target(removed.size());
+        for (int i : order) {
+            int least = std::min_element(loads.begin(), loads.end()) - loads.begin();
+            target[i] = least;
+            loads[least] += durations[removed[i]];
+        }
+        return target;
+    }
+
+    std::vector<int> exact_pair_repair(const std::vector<int> &removed) {
+        std::vector<uint32_t> sub(removed.size());
+        for (size_t i = 0; i < removed.size(); ++i) sub[i] = durations[removed[i]];
+        if (!BitsetSubsetDP::applicable(sub, 2)) return greedy_repair(removed, 2);
+        return BitsetSubsetDP(sub, 2).solve();
+    }
+
+    void rebuild_index() {
+        jobs_on.assign(solution->get_num_processors(), {});
+        std::vector<int> assignment = solution->get_assignment();
+        for (size_t job = 0; job < assignment.size(); ++job) jobs_on[assignment[job]].push_back(job);
+    }
+
+public:
+    LnsChain(Solution *sol, const std::string &destroy, TemperatureLaw *law, double temp, const LnsConfig &config,
+             unsigned int seed) :
+        config(config), destroy(destroy), law(law->clone()), temperature(temp), rng(seed) {
+        if (destroy != "extremes" && destroy != "random" && destroy != "pair") {
+            throw std::runtime_error("Unknown destroy operator " + destroy + " (expected extremes|random|pair)");
+        }
+        if (config.k < 1) throw std::runtime_error("LNS: k must be positive");
+        restart_from(*sol, seed);
+    }
+
+    // Продолжить от другого решения (общего рекорда): счетчики итераций сохраняются, температура — тоже
+    void restart_from(const Solution &start, unsigned int seed) {
+        solution = std::dynamic_pointer_cast<SchedulingSolution>(start.clone_new_seed(seed));
+        if (!solution) throw std::runtime_error("LNS works on scheduling solutions only");
+        durations = solution->get_job_times();
+        rebuild_index();
+        solution->set_journaling(true);
+        cost = best_cost = solution->get_cost();
+        lower_bound = solution->get_lower_bound();
+        best_solution.reset();
+        no_improvement = 0;
+    }
+
+    bool finished() const {
+        return no_improvement >= config.max_no_improvement || best_cost <= lower_bound ||
+               iterations >= config.max_iterations || solution->get_num_processors() < 2;
+    }
+
+    long long advance(long long budget) {
+        long long done = 0;
+        for (; done < budget && !finished(); ++done) {
+            std::vector<int> chosen = choose_processors();
+            std::vector<int> removed;
+            std::vector<int> source;  // процессор работы до разрушения
+            for (int p : chosen) {
+                removed.insert(removed.end(), jobs_on[p].begin(), jobs_on[p].end());
+                source.insert(source.end(), jobs_on[p].size(), p);
+            }
+            std::vector<int> target = destroy == "pair" ? exact_pair_repair(removed)
+                                                        : greedy_repair(removed, chosen.size());
+
+            size_t mark = solution->journal_size();
+            for (size_t i = 0; i < removed.size(); ++i) {
+                if (source[i] != chosen[target[i]]) solution->update_schedule(removed[i], source[i], chosen[target[i]]);
+            }
+            double new_cost = solution->get_cost();
+            double delta = new_cost - cost;
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            bool accept = delta <= 0 || std::exp(-delta / temperature) >= unit(rng);
+            bool new_best = accept && new_cost < best_cost;
+            law->observe(delta, accept, new_best);
+            temperature = law->get_next_temperature(iter++);
+            iterations++;
+            no_improvement = new_best || law->take_reheat() ? 0 : no_improvement + 1;
+            if (!accept) {
+                solution->rollback(mark);
+                continue;
+            }
+
+            accepted++;
+            cost = new_cost;
+            for (int p : chosen) jobs_on[p].clear();
+            for (size_t i = 0; i < removed.size(); ++i) jobs_on[chosen[target[i]]].push_back(removed[i]);
+            if (new_best) {
+                best_cost = new_cost;
+                best_solution.reset();
+                solution->clear_journal();
+            } else if (best_solution) {
+                solution->clear_journal();
+            } else if (solution->journal_size() > BEST_JOURNAL_LIMIT) {
+                materialize_best();
+            }
+        }
+        return done;
+    }
+
+    void run() override {
+        advance(std::numeric_limits<long long>::max());
+    }
+
+    std::shared_ptr<Solution> getLocalBestSolution() const override {
+        if (!best_solution) materialize_best();
+        return best_solution;
+    }
+
+    long long get_iterations() const override { return iterations; }
+
+    long long get_accepted() const { return accepted; }
+
+    double get_best_cost() const { return best_cost; }
+
+    const std::string &get_operator() const { return destroy; }
+};
+
+struct LnsThreadStats {
+    std::string destroy;
+    long long iterations = 0;
+    long long accepted = 0;
+    int restarts = 0;
+    double best_cost = 0;
+};
+
+struct LnsResult {
+    std::shared_ptr<Solution> best;
+    long long iterations = 0;
+    double seconds = 0;
+    std::vector<LnsThreadStats> threads;
+};
+
+// Параллельный режим: по цепочке на поток, у каждой свой оператор разрушения. Цепочки идут
+// отрезками по slice_iterations ходов, после каждого отрезка рекорд цепочки сравнивается с общим;
+// застрявшая цепочка перезапускается от общего рекорда, если он лучше ее собственного, иначе
+// останавливается.
+class LargeNeighbourhoodSearch {
+private:
+    ThreadPool &pool;
+    const TemperatureLaw &law;
+    double temperature;
+    LnsConfig config;
+
+    std::mutex mutex;
+    std::shared_ptr<Solution> best;
+    std::atomic<bool> solved{false};
+
+public:
+    LargeNeighbourhoodSearch(ThreadPool &pool, const TemperatureLaw &law, double temperature, const LnsConfig &config) :
+        pool(pool), law(law), temperature(temperature), config(config) {
+        if (config.operators.empty()) throw std::runtime_error("LNS: no destroy operators");
+    }
+
+    LnsResult run(const Solution &initial) {
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(config.seconds));
+        best = initial.clone();
+        LnsResult result;
+        result.threads.resize(pool.size());
+        std::vector<std::future<void>> workers;
+        for (size_t i = 0; i < pool.size(); ++i) {
+            workers.push_back(pool.submit([&, i]() {
+                LnsThreadStats &stats = result.threads[i];
+                stats.destroy = config.operators[i % config.operators.size()];
+                std::shared_ptr<Solution> from;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    from = best;
+                }
+                auto clone = law.clone();
+                LnsChain chain(from.get(), stats.destroy, clone.get(), temperature, config,
+                               derive_seed(config.seed, 0, i));
+                while (!solved && (config.seconds <= 0 || std::chrono::steady_clock::now() < deadline)) {
+                    chain.advance(config.slice_iterations);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (chain.get_best_cost() < best->get_cost()) best = chain.getLocalBestSolution();
+                    if (best->get_cost() <= dynamic_cast<SchedulingSolution &>(*best).get_lower_bound()) solved = true;
+                    if (!chain.finished()) continue;
+                    if (best->get_cost() >= chain.get_best_cost() ||
+                        chain.get_iterations() >= config.max_iterations) {
+                        break;
+                    }
+                    chain.restart_from(*best, derive_seed(config.seed, ++stats.restarts, i));
+                }
+                stats.iterations = chain.get_iterations();
+                stats.accepted = chain.get_accepted();
+                stats.best_cost = chain.get_best_cost();
+            }));
+        }
+        for (auto &future : workers) future.get();
+
+        result.best = best;
+        for (const auto &stats : result.threads) result.iterations += stats.iterations;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+};
+
+inline void print_lns_report(std::ostream &out, const LnsResult &result) {
+    out << "LNS: " << result.iterations << " moves in " << result.seconds << "s, best cost "
+        << result.best->get_cost() << "\n";
+    for (size_t i = 0; i < result.threads.size(); ++i) {
+        const LnsThreadStats &stats = result.threads[i];
+        out << "  thread " << i << " (" << stats.destroy << "): moves " << stats.iterations << ", accepted "
+            << stats.accepted << ", restarts " << stats.restarts << ", best cost " << stats.best_cost << "\n";
+    }
+}
@@ -0,0 +1,439 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOAD_KERNELS_X86 1
+#endif
+
+// Редукции по массивам загрузок процессоров (min/max/argmin/argmax/sum) для int32 и int64.
+// Вариант (AVX-512 / AVX2 / SSE4.2 / скалярный) выбирается один раз при первом вызове по CPUID.
+// argmin/argmax возвращают первый индекс экстремума, как std::min_element/std::max_element.
+namespace load_kernels {
+
+enum class Isa { Scalar, SSE42, AVX2, AVX512 };
+
+inline const char *isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return "AVX-512";
+        case Isa::AVX2: return "AVX2";
+        case Isa::SSE42: return "SSE4.2";
+        default: return "scalar";
+    }
+}
+
+template <typename T>
+struct MinMax {
+    T min;
+    T max;
+};
+
+// ---------- скалярные варианты ----------
+
+template <typename T>
+MinMax<T> minmax_scalar(const T *data, size_t n) {
+    auto extremes = std::minmax_element(data, data + n);
+    return {*extremes.first, *extremes.second};
+}
+
+template <typename T>
+int64_t sum_scalar(const T *data, size_t n) {
+    int64_t total = 0;
+    for (size_t i = 0; i < n; ++i) total += data[i];
+    return total;
+}
+
+template <typename T>
+size_t find_scalar(const T *data, size_t n, T value, size_t from = 0) {
+    for (size_t i = from; i < n; ++i) {
+        if (data[i] == value) return i;
+    }
+    return n;
+}
+
+#ifdef LOAD_KERNELS_X86
+
+// ---------- SSE4.2 ----------
+
+__attribute__((target("sse4.2")))
+inline MinMax<int32_t> minmax_sse42(const int32_t *data, size_t n) {
+    if (n < 4) return minmax_scalar(data, n);
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    __m128i hi = lo;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        lo = _mm_min_epi32(lo, v);
+        hi = _mm_max_epi32(hi, v);
+    }
+    alignas(16) int32_t l[4], h[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(l), lo);
+    _mm_store_si128(reinterpret_cast<__m128i *>(h), hi);
+    MinMax<int32_t> result = {*std::min_element(l, l + 4), *std::max_element(h, h + 4)};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("sse4.2")))
+inline MinMax<int64_t> minmax_sse42(const int64_t *data, size_t n) {
+    if (n < 2) return minmax_scalar(data, n);
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    __m128i hi = lo;
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        lo = _mm_blendv_epi8(lo, v, _mm_cmpgt_epi64(lo, v));
+        hi = _mm_blendv_epi8(hi, v, _mm_cmpgt_epi64(v, hi));
+    }
+    alignas(16) int64_t l[2], h[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(l), lo);
+    _mm_store_si128(reinterpret_cast<__m128i *>(h), hi);
+    MinMax<int64_t> result = {std::min(l[0], l[1]), std::max(h[0], h[1])};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("sse4.2")))
+inline int64_t sum_sse42(const int32_t *data, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+    alignas(16) int64_t parts[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(parts), acc);
+    return parts[0] + parts[1] + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("sse4.2")))
+inline int64_t sum_sse42(const int64_t *data, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+    }
+    alignas(16) int64_t parts[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(parts), acc);
+    return parts[0] + parts[1] + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("sse4.2")))
+inline size_t find_sse42(const int32_t *data, size_t n, int32_t value) {
+    __m128i needle = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, needle)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+__attribute__((target("sse4.2")))
+inline size_t find_sse42(const int64_t *data, size_t n, int64_t value) {
+    __m128i needle = _mm_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, needle)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+// ---------- AVX2 ----------
+
+__attribute__((target("avx2")))
+inline MinMax<int32_t> minmax_avx2(const int32_t *data, size_t n) {
+    if (n < 8) return minmax_scalar(data, n);
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    __m256i hi = lo;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        lo = _mm256_min_epi32(lo, v);
+        hi = _mm256_max_epi32(hi, v);
+    }
+    alignas(32) int32_t l[8], h[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(l), lo);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(h), hi);
+    MinMax<int32_t> result = {*std::min_element(l, l + 8), *std::max_element(h, h + 8)};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+inline MinMax<int64_t> minmax_avx2(const int64_t *data, size_t n) {
+    if (n < 4) return minmax_scalar(data, n);
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    __m256i hi = lo;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        lo = _mm256_blendv_epi8(lo, v, _mm256_cmpgt_epi64(lo, v));
+        hi = _mm256_blendv_epi8(hi, v, _mm256_cmpgt_epi64(v, hi));
+    }
+    alignas(32) int64_t l[4], h[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(l), lo);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(h), hi);
+    MinMax<int64_t> result = {*std::min_element(l, l + 4), *std::max_element(h, h + 4)};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+inline int64_t sum_avx2(const int32_t *data, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) int64_t parts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(parts), acc);
+    return parts[0] + parts[1] + parts[2] + parts[3] + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("avx2")))
+inline int64_t sum_avx2(const int64_t *data, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+    }
+    alignas(32) int64_t parts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(parts), acc);
+    return parts[0] + parts[1] + parts[2] + parts[3] + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("avx2")))
+inline size_t find_avx2(const int32_t *data, size_t n, int32_t value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, needle)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+__attribute__((target("avx2")))
+inline size_t find_avx2(const int64_t *data, size_t n, int64_t value) {
+    __m256i needle = _mm256_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, needle)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+// ---------- AVX-512 ----------
+
+__attribute__((target("avx512f")))
+inline MinMax<int32_t> minmax_avx512(const int32_t *data, size_t n) {
+    if (n < 16) return minmax_avx2(data, n);
+    __m512i lo = _mm512_loadu_si512(data);
+    __m512i hi = lo;
+    size_t i = 16;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        lo = _mm512_min_epi32(lo, v);
+        hi = _mm512_max_epi32(hi, v);
+    }
+    alignas(64) int32_t l[16], h[16];
+    _mm512_store_si512(l, lo);
+    _mm512_store_si512(h, hi);
+    MinMax<int32_t> result = {*std::min_element(l, l + 16), *std::max_element(h, h + 16)};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+inline MinMax<int64_t> minmax_avx512(const int64_t *data, size_t n) {
+    if (n < 8) return minmax_avx2(data, n);
+    __m512i lo = _mm512_loadu_si512(data);
+    __m512i hi = lo;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        lo = _mm512_min_epi64(lo, v);
+        hi = _mm512_max_epi64(hi, v);
+    }
+    alignas(64) int64_t l[8], h[8];
+    _mm512_store_si512(l, lo);
+    _mm512_store_si512(h, hi);
+    MinMax<int64_t> result = {*std::min_element(l, l + 8), *std::max_element(h, h + 8)};
+    for (; i < n; ++i) {
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+inline int64_t sum_avx512(const int32_t *data, size_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+    }
+    alignas(64) int64_t parts[8];
+    _mm512_store_si512(parts, acc);
+    return sum_scalar(parts, 8) + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+inline int64_t sum_avx512(const int64_t *data, size_t n) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_loadu_si512(data + i));
+    }
+    alignas(64) int64_t parts[8];
+    _mm512_store_si512(parts, acc);
+    return sum_scalar(parts, 8) + sum_scalar(data + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+inline size_t find_avx512(const int32_t *data, size_t n, int32_t value) {
+    __m512i needle = _mm512_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data + i), needle);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+__attribute__((target("avx512f")))
+inline size_t find_avx512(const int64_t *data, size_t n, int64_t value) {
+    __m512i needle = _mm512_set1_epi64(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(data + i), needle);
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return find_scalar(data, n, value, i);
+}
+
+#endif
+
+// ---------- диспетчеризация ----------
+
+inline Isa detect_isa() {
+#ifdef LOAD_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return Isa::SSE42;
+#endif
+    return Isa::Scalar;
+}
+
+inline Isa active_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+template <typename T>
+struct Table {
+    MinMax<T> (*minmax)(const T *, size_t);
+    int64_t (*sum)(const T *, size_t);
+    size_t (*find)(const T *, size_t, T);
+};
+
+template <typename T>
+size_t find_scalar_entry(const T *data, size_t n, T value) {
+    return find_scalar(data, n, value);
+}
+
+template <typename T>
+Table<T> make_table(Isa isa) {
+#ifdef LOAD_KERNELS_X86
+    switch (isa) {
+        case Isa::AVX512:
+            return {static_cast<MinMax<T> (*)(const T *, size_t)>(minmax_avx512),
+                    static_cast<int64_t (*)(const T *, size_t)>(sum_avx512),
+                    static_cast<size_t (*)(const T *, size_t, T)>(find_avx512)};
+        case Isa::AVX2:
+            return {static_cast<MinMax<T> (*)(const T *, size_t)>(minmax_avx2),
+                    static_cast<int64_t (*)(const T *, size_t)>(sum_avx2),
+                    static_cast<size_t (*)(const T *, size_t, T)>(find_avx2)};
+        case Isa::SSE42:
+            return {static_cast<MinMax<T> (*)(const T *, size_t)>(minmax_sse42),
+                    static_cast<int64_t (*)(const T *, size_t)>(sum_sse42),
+                    static_cast<size_t (*)(const T *, size_t, T)>(find_sse42)};
+        default:
+            break;
+    }
+#endif
+    return {minmax_scalar<T>, sum_scalar<T>, find_scalar_entry<T>};
+}
+
+template <typename T>
+const Table<T> &table() {
+    static const Table<T> instance = make_table<T>(active_isa());
+    return instance;
+}
+
+// Публичный интерфейс; n > 0. На коротких массивах косвенный вызов дороже самой редукции.
+
+constexpr size_t SIMD_THRESHOLD = 64;
+
+template <typename T>
+MinMax<T> minmax(const T *data, size_t n) {
+    if (n < SIMD_THRESHOLD) return minmax_scalar(data, n);
+    return table<T>().minmax(data, n);
+}
+
+template <typename T>
+T min(const T *data, size_t n) { return minmax(data, n).min; }
+
+template <typename T>
+T max(const T *data, size_t n) { return minmax(data, n).max; }
+
+template <typename T>
+int64_t sum(const T *data, size_t n) {
+    if (n < SIMD_THRESHOLD) return sum_scalar(data, n);
+    return table<T>().sum(data, n);
+}
+
+template <typename T>
+size_t find(const T *data, size_t n, T value) {
+    if (n < SIMD_THRESHOLD) return find_scalar(data, n, value);
+    return table<T>().find(data, n, value);
+}
+
+template <typename T>
+size_t argmin(const T *data, size_t n) { return find(data, n, min(data, n)); }
+
+template <typename T>
+size_t argmax(const T *data, size_t n) { return find(data, n, max(data, n)); }
+
+}
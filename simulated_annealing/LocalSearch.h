@@ -0,0 +1,124 @@
+#pragma once
+#include "Solution.h"
+#include <cmath>
+
+// Доводка после отжига: наискорейший спуск по перемещениям одной работы и обменам пар работ
+// между самым загруженным и самым свободным процессорами. Работы каждого процессора разложены
+// по корзинам классов длительностей (различных значений в экземпляре), поэтому лучший ход
+// ищется за O(число классов), а не перебором пар работ. Для uint8 это не больше 256 корзин.
+class LocalSearchPolisher {
+private:
+    struct Step {
+        int out_class = -1;  // класс, уходящий с максимального процессора
+        int in_class = -1;   // класс, приходящий с минимального (-1 — простое перемещение)
+        double score = 0;    // |gap - 2 * shift|, меньше — лучше
+    };
+
+    SchedulingSolution &solution;
+    int num_processors;
+    std::vector<int64_t> class_durations;  // по возрастанию
+    std::vector<std::vector<int>> buckets;
+    std::vector<int> prev_present;
+    std::vector<int> next_present;
+
+    int num_classes() const {
+        return class_durations.size();
+    }
+
+    std::vector<int> &bucket(int processor, int duration_class) {
+        return buckets[static_cast<size_t>(processor) * num_classes() + duration_class];
+    }
+
+    void consider(Step &best, int64_t gap, int out_class, int in_class) {
+        int64_t shift = class_durations[out_class] - (in_class < 0 ? 0 : class_durations[in_class]);
+        if (shift <= 0 || shift >= gap) return;
+        double score = std::abs(gap - 2.0 * shift);
+        if (best.out_class < 0 || score < best.score) {
+            best = {out_class, in_class, score};
+        }
+    }
+
+    Step find_best_step(int max_processor, int min_processor, int64_t gap) {
+        // Ближайший снизу/сверху класс, присутствующий на минимальном процессоре
+        int last = -1;
+        for (int c = 0; c < num_classes(); ++c) {
+            if (!bucket(min_processor, c).empty()) last = c;
+            prev_present[c] = last;
+        }
+        last = -1;
+        for (int c = num_classes() - 1; c >= 0; --c) {
+            if (!bucket(min_processor, c).empty()) last = c;
+            next_present[c] = last;
+        }
+
+        Step best;
+        for (int out = 0; out < num_classes(); ++out) {
+            if (class_durations[out] == 0 || bucket(max_processor, out).empty()) continue;
+            consider(best, gap, out, -1);
+
+            // Первый класс не короче идеальной длительности встречной работы и класс перед ним
+            double ideal = class_durations[out] - gap / 2.0;
+            int above = std::lower_bound(class_durations.begin(), class_durations.end(), ideal) - class_durations.begin();
+            int below = above - 1;
+            if (below >= 0 && prev_present[below] >= 0) consider(best, gap, out, prev_present[below]);
+            if (above < num_classes() && next_present[above] >= 0) consider(best, gap, out, next_present[above]);
+        }
+        return best;
+    }
+
+    void transfer(int duration_class, int from, int to) {
+        std::vector<int> &source = bucket(from, duration_class);
+        int job = source.back();
+        source.pop_back();
+        bucket(to, duration_class).push_back(job);
+        solution.update_schedule(job, from, to);
+    }
+
+public:
+    explicit LocalSearchPolisher(SchedulingSolution &sol) :
+        solution(sol),
+        num_processors(sol.get_num_processors()) {
+        int num_jobs = solution.get_num_jobs();
+        for (int job = 0; job < num_jobs; ++job) class_durations.push_back(solution.get_job_time(job));
+        std::sort(class_durations.begin(), class_durations.end());
+        class_durations.erase(std::unique(class_durations.begin(), class_durations.end()), class_durations.end());
+        buckets.resize(static_cast<size_t>(num_processors) * num_classes());
+        prev_present.resize(num_classes());
+        next_present.resize(num_classes());
+
+        std::vector<int> assignment = solution.get_assignment();
+        for (int job = 0; job < num_jobs; ++job) {
+            int duration_class = std::lower_bound(class_durations.begin(), class_durations.end(),
+                                                  solution.get_job_time(job)) - class_durations.begin();
+            bucket(assignment[job], duration_class).push_back(job);
+        }
+    }
+
+    // Возвращает число выполненных ходов. Каждый ход строго уменьшает сумму квадратов
+    // загрузок и не увеличивает K1, поэтому спуск конечен.
+    int run(int max_steps = 1000000) {
+        int steps = 0;
+        while (steps < max_steps && num_processors > 1) {
+            int max_processor = solution.get_most_loaded_processor();
+            int min_processor = solution.get_least_loaded_processor();
+            int64_t gap = solution.get_processor_load(max_processor) - solution.get_processor_load(min_processor);
+            if (gap < 2) break;
+
+            Step step = find_best_step(max_processor, min_processor, gap);
+            if (step.out_class < 0) break;
+
+            transfer(step.out_class, max_processor, min_processor);
+            if (step.in_class >= 0) {
+                transfer(step.in_class, min_processor, max_processor);
+            }
+            steps++;
+        }
+        return steps;
+    }
+};
+
+inline int polish_solution(Solution &solution, int max_steps = 1000000) {
+    SchedulingSolution &sched_solution = dynamic_cast<SchedulingSolution &>(solution);
+    LocalSearchPolisher polisher(sched_solution);
+    return polisher.run(max_steps);
+}
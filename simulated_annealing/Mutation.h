@@ -1,4 +1,7 @@
+#pragma once
 #include "Solution.h"
+#include <string>
+#include <stdexcept>
 
 class Mutation {
 public:
@@ -21,3 +24,54 @@ public:
         sched_solution.update_schedule(jobIndex, oldProcessor, newProcessor);
     }
 };
+
+// Обмен процессорами двух работ, стоящих на разных процессорах
+class SwapMutation : public Mutation {
+public:
+    void apply(Solution& solution) override {
+        SchedulingSolution &sched_solution = dynamic_cast<SchedulingSolution &>(solution);
+        std::mt19937 &rng = sched_solution.get_rng();
+        std::uniform_int_distribution<int> job_dist(0, sched_solution.get_num_jobs() - 1);
+        int first = job_dist(rng);
+        int firstProcessor = sched_solution.get_job_processor(first);
+        // Ограничение попыток: если почти все работы на одном процессоре, обмен вырождается
+        for (int attempt = 0; attempt < 32; ++attempt) {
+            int second = job_dist(rng);
+            int secondProcessor = sched_solution.get_job_processor(second);
+            if (secondProcessor != firstProcessor) {
+                sched_solution.update_schedule(first, firstProcessor, secondProcessor);
+                sched_solution.update_schedule(second, secondProcessor, firstProcessor);
+                return;
+            }
+        }
+    }
+};
+
+// Перенос случайной работы с самого загруженного процессора на самый свободный
+class BalancingMutation : public Mutation {
+public:
+    void apply(Solution& solution) override {
+        SchedulingSolution &sched_solution = dynamic_cast<SchedulingSolution &>(solution);
+        std::mt19937 &rng = sched_solution.get_rng();
+        std::uniform_int_distribution<int> job_dist(0, sched_solution.get_num_jobs() - 1);
+        int maxProcessor = sched_solution.get_most_loaded_processor();
+        int minProcessor = sched_solution.get_least_loaded_processor();
+        if (maxProcessor == minProcessor) return;
+        // Работа максимального процессора ищется случайными пробами, в среднем за M попыток
+        int attempts = 4 * sched_solution.get_num_processors();
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            int jobIndex = job_dist(rng);
+            if (sched_solution.get_job_processor(jobIndex) == maxProcessor) {
+                sched_solution.update_schedule(jobIndex, maxProcessor, minProcessor);
+                return;
+            }
+        }
+    }
+};
+
+inline std::shared_ptr<Mutation> make_mutation(const std::string &name) {
+    if (name == "move") return std::make_shared<SchedulingMutation>();
+    if (name == "swap") return std::make_shared<SwapMutation>();
+    if (name == "balance") return std::make_shared<BalancingMutation>();
+    throw std::runtime_error("Unknown mutation " + name + " (expected move|swap|balance)");
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include "CoroutineChains.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Индексированная min-куча процессоров по загрузке: наименее загруженный — за O(1),
+// изменение загрузки любого процессора — за O(log M)
+class LoadHeap {
+private:
+    std::vector<int64_t> loads;
+    std::vector<int> heap;      // номера процессоров
+    std::vector<int> position;  // место процессора в heap
+
+    bool less(int a, int b) const {
+        return loads[heap[a]] < loads[heap[b]] || (loads[heap[a]] == loads[heap[b]] && heap[a] < heap[b]);
+    }
+
+    void swap_nodes(int a, int b) {
+        std::swap(heap[a], heap[b]);
+        position[heap[a]] = a;
+        position[heap[b]] = b;
+    }
+
+    void sift_up(int i) {
+        while (i > 0 && less(i, (i - 1) / 2)) {
+            swap_nodes(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void sift_down(int i) {
+        int n = heap.size();
+        while (true) {
+            int smallest = i;
+            for (int child = 2 * i + 1; child <= 2 * i + 2 && child < n; ++child) {
+                if (less(child, smallest)) smallest = child;
+            }
+            if (smallest == i) return;
+            swap_nodes(i, smallest);
+            i = smallest;
+        }
+    }
+
+public:
+    explicit LoadHeap(int num_processors) : loads(num_processors, 0), heap(num_processors), position(num_processors) {
+        for (int p = 0; p < num_processors; ++p) heap[p] = position[p] = p;
+    }
+
+    int least_loaded() const { return heap[0]; }
+
+    int64_t load(int processor) const { return loads[processor]; }
+
+    const std::vector<int64_t> &all_loads() const { return loads; }
+
+    void add(int processor, int64_t delta) {
+        loads[processor] += delta;
+        if (delta > 0) sift_down(position[processor]);
+        else sift_up(position[processor]);
+    }
+
+    int64_t spread() const {
+        auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+        return *hi - *lo;
+    }
+};
+
+struct OnlineConfig {
+    int num_processors = 40;
+    size_t window = 4096;              // последних работ, которые еще можно переставлять
+    int interval_ms = 50;              // пауза между проходами балансировки
+    long long pass_iterations = 20000; // итераций отжига за проход
+    double temperature = 10.0;
+    std::string law = "boltzmann";
+    unsigned int seed = 1;
+};
+
+struct OnlineStats {
+    uint64_t jobs = 0;
+    uint64_t moves = 0;
+    uint64_t passes = 0;
+    uint64_t rejected_passes = 0;  // проходы, не улучшившие K1 к моменту применения
+};
+
+// Онлайн-режим: каждая приходящая работа сразу ставится на наименее загруженный процессор.
+// Фоновый поток периодически снимает копию окна последних работ и загрузок, коротким отжигом
+// переставляет работы окна (загрузки остальных работ — неподвижная база) и применяет найденные
+// переносы, если K1 от этого не вырос. Память — окно и M загрузок, от длины потока не зависит.
+// О каждом решении сообщается через emit: ("assign" | "move", id работы, процессор).
+class OnlineScheduler {
+public:
+    using Emit = std::function<void(const char *kind, const std::string &id, int processor)>;
+
+private:
+    struct WindowJob {
+        uint64_t serial;
+        std::string id;
+        uint32_t duration;
+        int processor;
+    };
+
+    OnlineConfig config;
+    Emit emit;
+    std::shared_ptr<TemperatureLaw> law;
+    LoadHeap heap;
+    std::vector<WindowJob> window;  // кольцевой буфер
+    size_t head = 0;                // место следующей работы
+    OnlineStats stats;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread balancer;
+    SmallRng rng;
+
+    // Отжиг окна на копии: назначения работ окна при неподвижной базе остальных загрузок
+    std::vector<int> anneal_window(const std::vector<WindowJob> &jobs, std::vector<int64_t> loads) {
+        int m = config.num_processors;
+        std::vector<int> assignment(jobs.size());
+        for (size_t i = 0; i < jobs.size(); ++i) assignment[i] = jobs[i].processor;
+        std::vector<int> best = assignment;
+        auto spread = [&]() {
+            auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+            return *hi - *lo;
+        };
+        int64_t cost = spread();
+        int64_t best_cost = cost;
+        for (long long iter = 0; iter < config.pass_iterations && best_cost > 0; ++iter) {
+            int i = rng.below(jobs.size());
+            int from = assignment[i];
+            int to = rng.below(m - 1);
+            if (to >= from) to++;
+            loads[from] -= jobs[i].duration;
+            loads[to] += jobs[i].duration;
+            int64_t candidate = spread();
+            double delta = static_cast<double>(candidate - cost);
+            if (delta <= 0 || std::exp(-delta / law->get_next_temperature(iter)) >= rng.unit()) {
+                assignment[i] = to;
+                cost = candidate;
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = assignment;
+                }
+            } else {
+                loads[from] += jobs[i].duration;
+                loads[to] -= jobs[i].duration;
+            }
+        }
+        return best;
+    }
+
+    void rebalance() {
+        std::vector<WindowJob> snapshot;
+        std::vector<int64_t> loads;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot = window;
+            loads = heap.all_loads();
+        }
+        if (snapshot.empty()) return;
+        std::vector<int> target = anneal_window(snapshot, loads);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.passes++;
+        // За время прохода окно могло сдвинуться: переносятся только работы, оставшиеся на месте
+        std::vector<std::pair<size_t, int>> moves;
+        for (size_t i = 0; i < snapshot.size(); ++i) {
+            if (target[i] == snapshot[i].processor) continue;
+            if (window[i].serial != snapshot[i].serial || window[i].processor != snapshot[i].processor) continue;
+            moves.emplace_back(i, target[i]);
+        }
+        // Загрузки тоже могли измениться: проверяем итоговый K1 на текущих загрузках
+        std::vector<int64_t> after = heap.all_loads();
+        for (auto [i, to] : moves) {
+            after[window[i].processor] -= window[i].duration;
+            after[to] += window[i].duration;
+        }
+        auto [lo, hi] = std::minmax_element(after.begin(), after.end());
+        if (moves.empty() || *hi - *lo >= heap.spread()) {
+            if (!moves.empty()) stats.rejected_passes++;
+            return;
+        }
+        for (auto [i, to] : moves) {
+            WindowJob &job = window[i];
+            heap.add(job.processor, -static_cast<int64_t>(job.duration));
+            heap.add(to, job.duration);
+            job.processor = to;
+            emit("move", job.id, to);
+            stats.moves++;
+        }
+    }
+
+public:
+    OnlineScheduler(const OnlineConfig &config, Emit emit) :
+        config(config), emit(std::move(emit)), law(make_temperature_law(config.law, config.temperature)),
+        heap(config.num_processors) {
+        if (config.num_processors < 2) throw std::runtime_error("Online mode needs at least 2 processors");
+        if (config.window == 0) throw std::runtime_error("Online mode: window must be positive");
+        if (dynamic_cast<AdaptiveLaw *>(law.get())) {
+            throw std::runtime_error("Online mode restarts the law every pass; adaptive is not supported");
+        }
+        rng.state = config.seed;
+        window.reserve(config.window);
+        balancer = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping) {
+                wake.wait_for(lock, std::chrono::milliseconds(this->config.interval_ms));
+                if (stopping) break;
+                lock.unlock();
+                rebalance();
+                lock.lock();
+            }
+        });
+    }
+
+    ~OnlineScheduler() { finish(); }
+
+    // Назначение сразу, на наименее загруженный процессор
+    void submit(const std::string &id, uint32_t duration) {
+        std::lock_guard<std::mutex> lock(mutex);
+        int processor = heap.least_loaded();
+        heap.add(processor, duration);
+        WindowJob job{stats.jobs++, id, duration, processor};
+        if (window.size() < config.window) {
+            window.push_back(std::move(job));
+        } else {
+            window[head] = std::move(job);
+        }
+        head = (head + 1) % config.window;
+        emit("assign", id, processor);
+    }
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        wake.notify_all();
+        if (balancer.joinable()) balancer.join();
+    }
+
+    OnlineStats get_stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    int64_t get_cost() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return heap.spread();
+    }
+};
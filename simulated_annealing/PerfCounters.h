@@ -0,0 +1,187 @@
+#pragma once
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <mutex>
+
+// Аппаратные счетчики через perf_event_open. Включаются переменной окружения SA_PERF=1;
+// если ядро или контейнер их не дают, счетчик просто помечается недоступным.
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_REFERENCES,
+    PERF_CACHE_MISSES,
+    PERF_LLC_LOADS,
+    PERF_LLC_LOAD_MISSES,
+    PERF_BRANCHES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_COUNT
+};
+
+inline const char *perf_event_name(int event) {
+    static const char *names[PERF_EVENT_COUNT] = {
+        "cycles", "instructions", "cache-references", "cache-misses",
+        "LLC-loads", "LLC-load-misses", "branches", "branch-misses"
+    };
+    return names[event];
+}
+
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT] = {};
+    bool valid[PERF_EVENT_COUNT] = {};
+
+    bool any_valid() const {
+        for (bool v : valid) if (v) return true;
+        return false;
+    }
+
+    PerfSample &operator+=(const PerfSample &other) {
+        for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            if (!other.valid[i]) continue;
+            values[i] += other.values[i];
+            valid[i] = true;
+        }
+        return *this;
+    }
+
+    double ratio(int numerator, int denominator) const {
+        if (!valid[numerator] || !valid[denominator] || values[denominator] == 0) return -1;
+        return static_cast<double>(values[numerator]) / values[denominator];
+    }
+};
+
+inline bool perf_requested() {
+    const char *env = std::getenv("SA_PERF");
+    return env && std::strcmp(env, "0") != 0;
+}
+
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_COUNT];
+
+    static int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // pid = 0, cpu = -1: только вызывающий поток, на любом ядре
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static uint64_t cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+
+public:
+    // Счетчики привязаны к потоку, в котором создан объект
+    PerfCounters() {
+        for (int &fd : fds) fd = -1;
+        if (!perf_requested()) return;
+        fds[PERF_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[PERF_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[PERF_CACHE_REFERENCES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+        fds[PERF_CACHE_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[PERF_LLC_LOADS] = open_event(PERF_TYPE_HW_CACHE, cache_config(
+            PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS));
+        fds[PERF_LLC_LOAD_MISSES] = open_event(PERF_TYPE_HW_CACHE, cache_config(
+            PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        fds[PERF_BRANCHES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+        fds[PERF_BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    ~PerfCounters() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const {
+        for (int fd : fds) if (fd >= 0) return true;
+        return false;
+    }
+
+    void start() {
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    PerfSample stop() {
+        PerfSample sample;
+        for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t data[3];
+            if (read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+            // Масштабирование при мультиплексировании счетчиков ядром
+            double scale = static_cast<double>(data[1]) / data[2];
+            sample.values[i] = static_cast<uint64_t>(data[0] * scale);
+            sample.valid[i] = true;
+        }
+        return sample;
+    }
+};
+
+// Сумма по потокам одного замера
+class PerfAccumulator {
+private:
+    std::mutex mutex;
+    PerfSample total;
+public:
+    void add(const PerfSample &sample) {
+        std::lock_guard<std::mutex> lock(mutex);
+        total += sample;
+    }
+
+    PerfSample get() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return total;
+    }
+};
+
+inline void print_perf_report(std::ostream &out, const std::string &label, const PerfSample &sample,
+                              long long iterations, int num_jobs) {
+    if (!perf_requested()) return;
+    out << "[perf] " << label;
+    if (!sample.any_valid()) {
+        out << ": hardware counters unavailable\n";
+        return;
+    }
+    out << " (iterations: " << iterations << ", jobs: " << num_jobs << ")\n";
+    for (int i = 0; i < PERF_EVENT_COUNT; ++i) {
+        out << "  " << std::setw(18) << std::left << perf_event_name(i) << std::right;
+        if (!sample.valid[i]) {
+            out << "n/a\n";
+            continue;
+        }
+        out << std::setw(16) << sample.values[i];
+        if (iterations > 0) out << "  per iter: " << static_cast<double>(sample.values[i]) / iterations;
+        if (num_jobs > 0) out << "  per job: " << static_cast<double>(sample.values[i]) / num_jobs;
+        out << "\n";
+    }
+    double ipc = sample.ratio(PERF_INSTRUCTIONS, PERF_CYCLES);
+    double cache_miss_rate = sample.ratio(PERF_CACHE_MISSES, PERF_CACHE_REFERENCES);
+    double llc_miss_rate = sample.ratio(PERF_LLC_LOAD_MISSES, PERF_LLC_LOADS);
+    double branch_miss_rate = sample.ratio(PERF_BRANCH_MISSES, PERF_BRANCHES);
+    if (ipc >= 0) out << "  IPC: " << ipc << "\n";
+    if (cache_miss_rate >= 0) out << "  cache miss rate: " << cache_miss_rate * 100 << "%\n";
+    if (llc_miss_rate >= 0) out << "  LLC load miss rate: " << llc_miss_rate * 100 << "%\n";
+    if (branch_miss_rate >= 0) out << "  branch miss rate: " << branch_miss_rate * 100 << "%\n";
+}
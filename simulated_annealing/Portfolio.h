@@ -0,0 +1,166 @@
+#pragma once
+#include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+
+// Портфель конфигураций (закон охлаждения × мутация). Каждый поток раз за разом берет
+// конфигурацию сэмплированием Томпсона, отжигает от текущего рекорда короткий отрезок и
+// получает награду 0/1 — улучшил ли отрезок общий рекорд на момент своего завершения.
+// Такая награда не зависит от масштаба стоимости (первые отрезки от случайного решения
+// не обесценивают последующие) и не засчитывает выигрыш, который другой поток уже перекрыл.
+// Так ядра сами смещаются к тому, что выигрывает на этом экземпляре.
+struct PortfolioArm {
+    std::string law;
+    std::string mutation;
+    int pulls = 0;
+    int wins = 0;                // отрезков, улучшивших общий рекорд
+    double improvement = 0;      // суммарное улучшение рекорда
+    double seconds = 0;
+};
+
+// Бернуллиевские руки с априорным Beta(1, 1): выбирается рука с наибольшей выборкой
+// из апостериорного Beta(1 + успехи, 1 + неудачи)
+class ThompsonBandit {
+private:
+    std::vector<int> successes;
+    std::vector<int> failures;
+    std::mt19937 rng;
+
+    double sample_beta(double a, double b) {
+        double x = std::gamma_distribution<double>(a, 1.0)(rng);
+        double y = std::gamma_distribution<double>(b, 1.0)(rng);
+        return x / (x + y);
+    }
+
+public:
+    ThompsonBandit(size_t arms, unsigned int seed) : successes(arms, 0), failures(arms, 0), rng(seed) {}
+
+    int select() {
+        int chosen = 0;
+        double chosen_sample = -1;
+        for (size_t a = 0; a < successes.size(); ++a) {
+            double sample = sample_beta(1.0 + successes[a], 1.0 + failures[a]);
+            if (sample > chosen_sample) {
+                chosen_sample = sample;
+                chosen = a;
+            }
+        }
+        return chosen;
+    }
+
+    void update(int arm, bool success) {
+        if (success) successes[arm]++;
+        else failures[arm]++;
+    }
+};
+
+struct PortfolioConfig {
+    std::vector<std::string> laws = {"boltzmann", "cauchy", "logcauchy", "adaptive"};
+    std::vector<std::string> mutations = {"move", "swap", "balance"};
+    double seconds = 10.0;           // бюджет по времени на все потоки
+    long long slice_iterations = 2000;
+    unsigned int seed = 1;
+};
+
+struct PortfolioResult {
+    std::shared_ptr<Solution> best;
+    std::vector<PortfolioArm> arms;
+    int slices = 0;
+};
+
+class PortfolioSolver {
+private:
+    struct ArmState {
+        std::shared_ptr<TemperatureLaw> law;
+        std::shared_ptr<Mutation> mutation;
+        double initial_temp;
+    };
+
+    ThreadPool &pool;
+    PortfolioConfig config;
+    std::vector<PortfolioArm> arms;
+    std::vector<ArmState> states;
+    std::mutex mutex;
+    std::shared_ptr<Solution> best;
+    std::unique_ptr<ThompsonBandit> bandit;
+    int total_pulls = 0;
+
+    void worker(int thread_index, std::chrono::steady_clock::time_point deadline) {
+        for (int slice = 0; std::chrono::steady_clock::now() < deadline; ++slice) {
+            int arm;
+            std::shared_ptr<Solution> start;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                arm = bandit->select();
+                arms[arm].pulls++;
+                total_pulls++;
+                start = best;
+            }
+            unsigned int seed = derive_seed(config.seed, slice, thread_index);
+            auto begin = std::chrono::steady_clock::now();
+            SimulatedAnnealing sa(start.get(), states[arm].mutation.get(), states[arm].law.get(),
+                                  states[arm].initial_temp, seed);
+            sa.advance(config.slice_iterations);
+            auto result = sa.getLocalBestSolution();
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            // Успех считается относительно рекорда на момент завершения, а не выдачи отрезка
+            bool improved = result->get_cost() < best->get_cost();
+            bandit->update(arm, improved);
+            arms[arm].seconds += elapsed;
+            if (improved) {
+                arms[arm].wins++;
+                arms[arm].improvement += best->get_cost() - result->get_cost();
+                best = result;
+            }
+        }
+    }
+
+public:
+    PortfolioSolver(ThreadPool &pool, const PortfolioConfig &config) : pool(pool), config(config) {}
+
+    PortfolioResult run(const Solution &initial) {
+        best = initial.clone();
+        arms.clear();
+        states.clear();
+        total_pulls = 0;
+        for (const auto &law_name : config.laws) {
+            for (const auto &mutation_name : config.mutations) {
+                ArmState state;
+                state.mutation = make_mutation(mutation_name);
+                // Начальная температура своя для каждой мутации: у них разный масштаб приращений
+                state.initial_temp = calibrate_temperature(initial, *state.mutation, 0.2, 100, config.seed);
+                state.law = make_temperature_law(law_name, state.initial_temp);
+                states.push_back(state);
+                arms.push_back({law_name, mutation_name});
+            }
+        }
+
+        bandit = std::make_unique<ThompsonBandit>(arms.size(), config.seed);
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(config.seconds));
+        std::vector<std::future<void>> workers;
+        for (size_t i = 0; i < pool.size(); ++i) {
+            workers.push_back(pool.submit([this, i, deadline]() { worker(i, deadline); }));
+        }
+        for (auto &future : workers) future.get();
+
+        return {best, arms, total_pulls};
+    }
+};
+
+inline void print_portfolio_report(std::ostream &out, const PortfolioResult &result) {
+    out << "Portfolio: " << result.slices << " slices, best cost " << result.best->get_cost() << "\n";
+    for (const auto &arm : result.arms) {
+        out << "  " << arm.law << " + " << arm.mutation << ": pulls " << arm.pulls
+            << ", wins " << arm.wins
+            << ", improvement " << arm.improvement << ", seconds " << arm.seconds << "\n";
+    }
+}
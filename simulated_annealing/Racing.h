@@ -0,0 +1,112 @@
+#pragma once
+#include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+// Гонка цепочек отжига (successive halving): стартует много цепочек с разными зернами,
+// после каждого этапа худшая доля снимается, а освободившийся бюджет и ядра достаются
+// выжившим. Если выживших меньше, чем потоков пула, лучшие цепочки раздваиваются (fork)
+// и продолжают с той же температуры с разными генераторами.
+struct RacingConfig {
+    int chains = 16;            // стартовое число цепочек
+    int eta = 2;                // после этапа остается 1/eta цепочек; 1 — равномерное распределение
+    long long budget = 200000;  // общий бюджет итераций на все цепочки и этапы
+    unsigned int seed = 1;
+};
+
+struct RaceResult {
+    std::shared_ptr<Solution> best;
+    int rungs = 0;
+    long long iterations = 0;
+    std::vector<double> rung_costs;  // лучшая стоимость после каждого этапа
+};
+
+class AnnealingRace {
+private:
+    struct Chain {
+        std::unique_ptr<SimulatedAnnealing> sa;
+        std::shared_ptr<Solution> best;
+        unsigned int id;
+        int restarts = 0;
+    };
+
+    ThreadPool &pool;
+    Mutation &mutation;
+    TemperatureLaw &law;
+    double initial_temp;
+    RacingConfig config;
+
+    int count_rungs() const {
+        if (config.eta <= 1 || config.chains <= 1) return 1;
+        int rungs = 1;
+        for (int active = config.chains; active > 1; active = (active + config.eta - 1) / config.eta) rungs++;
+        return rungs;
+    }
+
+    // Цепочка, остановившаяся по своему критерию, перезапускается из своего лучшего решения
+    long long advance(Chain &chain, long long budget, int rung) {
+        long long done = 0;
+        while (done < budget) {
+            if (chain.sa->finished()) {
+                chain.best = chain.sa->getLocalBestSolution();
+                unsigned int seed = derive_seed(config.seed + chain.id, rung, ++chain.restarts);
+                chain.sa = std::make_unique<SimulatedAnnealing>(chain.best.get(), &mutation, &law, initial_temp, seed);
+            }
+            done += chain.sa->advance(budget - done);
+        }
+        chain.best = chain.sa->getLocalBestSolution();
+        return done;
+    }
+
+public:
+    AnnealingRace(ThreadPool &pool, Mutation &mutation, TemperatureLaw &law, double temp, const RacingConfig &config) :
+        pool(pool), mutation(mutation), law(law), initial_temp(temp), config(config) {}
+
+    RaceResult run(const Solution &initial) {
+        RaceResult result;
+        std::vector<Chain> chains;
+        for (int i = 0; i < config.chains; ++i) {
+            unsigned int seed = derive_seed(config.seed, 0, i);
+            auto start = initial.clone_new_seed(seed);
+            chains.push_back({std::make_unique<SimulatedAnnealing>(start.get(), &mutation, &law, initial_temp, seed),
+                              start, static_cast<unsigned int>(i)});
+        }
+
+        int rungs = count_rungs();
+        long long rung_budget = config.budget / rungs;
+        unsigned int next_id = config.chains;
+        for (int rung = 0; rung < rungs; ++rung) {
+            long long per_chain = rung_budget / chains.size();
+            long long extra = rung_budget % chains.size();
+            std::vector<std::future<long long>> futures;
+            for (size_t i = 0; i < chains.size(); ++i) {
+                long long share = per_chain + (static_cast<long long>(i) < extra ? 1 : 0);
+                Chain *chain = &chains[i];
+                futures.push_back(pool.submit([this, chain, share, rung]() { return advance(*chain, share, rung); }));
+            }
+            for (auto &future : futures) result.iterations += future.get();
+
+            std::sort(chains.begin(), chains.end(), [](const Chain &a, const Chain &b) {
+                return a.best->get_cost() < b.best->get_cost();
+            });
+            result.rung_costs.push_back(chains.front().best->get_cost());
+            if (!result.best || chains.front().best->get_cost() < result.best->get_cost()) {
+                result.best = chains.front().best;
+            }
+            result.rungs++;
+            if (rung + 1 == rungs) break;
+
+            size_t survivors = std::max<size_t>(1, (chains.size() + config.eta - 1) / config.eta);
+            chains.resize(survivors);
+            // Освободившиеся потоки получают копии лучших цепочек
+            for (size_t i = 0; chains.size() < pool.size(); ++i) {
+                const Chain &parent = chains[i % survivors];
+                unsigned int id = next_id++;
+                chains.push_back({parent.sa->fork(derive_seed(config.seed + id, rung, 0)), parent.best, id});
+            }
+        }
+        return result;
+    }
+};
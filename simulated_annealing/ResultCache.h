@@ -0,0 +1,253 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// K1 зависит только от мультимножества длительностей и числа процессоров, поэтому ключ кэша —
+// гистограмма длительностей и M. Решение хранится «по классам»: сколько работ каждой
+// длительности стоит на каждом процессоре; так его можно применить к любому порядку работ.
+constexpr int NUM_SMALL_DURATIONS = 256;
+
+struct InstanceFingerprint {
+    uint32_t num_processors = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> histogram;  // (длительность, число работ) по возрастанию
+    uint64_t hash = 0;
+
+    bool operator==(const InstanceFingerprint &other) const {
+        return hash == other.hash && num_processors == other.num_processors && histogram == other.histogram;
+    }
+};
+
+inline uint64_t mix_hash(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+inline uint64_t fingerprint_hash(const InstanceFingerprint &fingerprint) {
+    uint64_t hash = mix_hash(0, fingerprint.num_processors);
+    for (const auto &[duration, count] : fingerprint.histogram) {
+        hash = mix_hash(mix_hash(hash, duration), count);
+    }
+    return hash;
+}
+
+// Один проход по длительностям: короткие считаются в массиве, длинные — в хэш-таблице
+inline InstanceFingerprint make_fingerprint(const std::vector<uint32_t> &durations, int num_processors) {
+    InstanceFingerprint fingerprint;
+    fingerprint.num_processors = num_processors;
+    std::array<uint32_t, NUM_SMALL_DURATIONS> small = {};
+    std::unordered_map<uint32_t, uint32_t> large;
+    for (uint32_t d : durations) {
+        if (d < NUM_SMALL_DURATIONS) small[d]++;
+        else large[d]++;
+    }
+    for (int d = 0; d < NUM_SMALL_DURATIONS; ++d) {
+        if (small[d]) fingerprint.histogram.emplace_back(d, small[d]);
+    }
+    size_t first_large = fingerprint.histogram.size();
+    fingerprint.histogram.insert(fingerprint.histogram.end(), large.begin(), large.end());
+    std::sort(fingerprint.histogram.begin() + first_large, fingerprint.histogram.end());
+    fingerprint.hash = fingerprint_hash(fingerprint);
+    return fingerprint;
+}
+
+struct ClassAssignment {
+    double cost = 0;
+    // [класс длительности][процессор] -> число работ; только для присутствующих классов
+    std::vector<uint32_t> classes;
+    std::vector<std::vector<uint32_t>> counts;
+
+    static ClassAssignment from_assignment(const std::vector<uint32_t> &durations,
+                                           const std::vector<int> &assignment,
+                                           int num_processors, double cost) {
+        ClassAssignment result;
+        result.cost = cost;
+        std::unordered_map<uint32_t, int> index;
+        for (size_t job = 0; job < durations.size(); ++job) {
+            auto [slot, inserted] = index.try_emplace(durations[job], result.classes.size());
+            if (inserted) {
+                result.classes.push_back(durations[job]);
+                result.counts.emplace_back(num_processors, 0);
+            }
+            result.counts[slot->second][assignment[job]]++;
+        }
+        return result;
+    }
+
+    // Раздает работы каждого класса по процессорам согласно сохраненным счетчикам
+    std::vector<int> to_assignment(const std::vector<uint32_t> &durations) const {
+        std::unordered_map<uint32_t, int> index;
+        for (size_t i = 0; i < classes.size(); ++i) index[classes[i]] = i;
+        std::vector<std::vector<uint32_t>> remaining = counts;
+        std::vector<int> cursor(classes.size(), 0);
+        std::vector<int> assignment(durations.size());
+        for (size_t job = 0; job < durations.size(); ++job) {
+            int slot = index.at(durations[job]);
+            int &processor = cursor[slot];
+            while (remaining[slot][processor] == 0) processor++;
+            remaining[slot][processor]--;
+            assignment[job] = processor;
+        }
+        return assignment;
+    }
+};
+
+// LRU-кэш в памяти с необязательным сохранением в файл. Потокобезопасен.
+class ResultCache {
+private:
+    struct Entry {
+        InstanceFingerprint fingerprint;
+        ClassAssignment solution;
+    };
+
+    size_t capacity;
+    std::string filename;
+    std::list<Entry> entries;  // голова — самый свежий
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t dirty = 0;                // записей, измененных после последнего сохранения
+    mutable std::mutex mutex;
+    mutable std::mutex file_mutex;   // сохранения не пересекаются между собой
+
+    static constexpr uint32_t FILE_MAGIC = 0x32434153;  // "SAC2"
+
+    void insert_locked(Entry entry) {
+        auto found = index.find(entry.fingerprint.hash);
+        if (found != index.end()) {
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        entries.push_front(std::move(entry));
+        index[entries.front().fingerprint.hash] = entries.begin();
+        dirty++;
+        while (entries.size() > capacity) {
+            index.erase(entries.back().fingerprint.hash);
+            entries.pop_back();
+        }
+    }
+
+public:
+    explicit ResultCache(size_t capacity, const std::string &file = "") : capacity(capacity), filename(file) {
+        if (!filename.empty()) load();
+        dirty = 0;
+    }
+
+    std::optional<ClassAssignment> lookup(const InstanceFingerprint &fingerprint) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(fingerprint.hash);
+        if (found == index.end() || !(found->second->fingerprint == fingerprint)) return std::nullopt;
+        entries.splice(entries.begin(), entries, found->second);
+        return entries.front().solution;
+    }
+
+    // Сохраняет решение, если оно лучше уже известного для этого экземпляра
+    void store(const InstanceFingerprint &fingerprint, ClassAssignment solution) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(fingerprint.hash);
+        if (found != index.end() && found->second->fingerprint == fingerprint &&
+            found->second->solution.cost <= solution.cost) {
+            entries.splice(entries.begin(), entries, found->second);
+            return;
+        }
+        insert_locked({fingerprint, std::move(solution)});
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    // Формат файла: magic, число записей; запись — M, cost, число пар гистограммы и сами пары,
+    // число классов и для каждого класса длительность и M счетчиков.
+    // Под блокировкой кэша образ файла только собирается в памяти; запись идет уже без нее,
+    // и поиск в кэше на время записи не останавливается.
+    void save() {
+        if (filename.empty()) return;
+        std::lock_guard<std::mutex> file_lock(file_mutex);
+        std::string image;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            image = serialize_locked();
+            dirty = 0;
+        }
+        std::string tmp = filename + ".tmp";
+        std::ofstream out(tmp, std::ios::binary);
+        out.write(image.data(), image.size());
+        out.close();
+        std::rename(tmp.c_str(), filename.c_str());
+    }
+
+    // Сохраняет файл, только если с прошлого сохранения что-то изменилось
+    bool flush() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (dirty == 0) return false;
+        }
+        save();
+        return true;
+    }
+
+private:
+    std::string serialize_locked() const {
+        std::string image;
+        auto put = [&](const void *data, size_t size) { image.append(static_cast<const char *>(data), size); };
+        uint32_t magic = FILE_MAGIC;
+        uint32_t count = entries.size();
+        put(&magic, sizeof(magic));
+        put(&count, sizeof(count));
+        // От старых к новым, чтобы при загрузке сохранился порядок LRU
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            put(&it->fingerprint.num_processors, sizeof(uint32_t));
+            put(&it->solution.cost, sizeof(double));
+            uint32_t num_bins = it->fingerprint.histogram.size();
+            put(&num_bins, sizeof(num_bins));
+            for (const auto &[duration, jobs] : it->fingerprint.histogram) {
+                put(&duration, sizeof(uint32_t));
+                put(&jobs, sizeof(uint32_t));
+            }
+            uint32_t num_classes = it->solution.classes.size();
+            put(&num_classes, sizeof(num_classes));
+            for (uint32_t c = 0; c < num_classes; ++c) {
+                put(&it->solution.classes[c], sizeof(uint32_t));
+                put(it->solution.counts[c].data(), sizeof(uint32_t) * it->fingerprint.num_processors);
+            }
+        }
+        return image;
+    }
+
+    void load() {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in.is_open()) return;
+        auto get = [&](void *data, size_t size) { return static_cast<bool>(in.read(static_cast<char *>(data), size)); };
+        uint32_t magic, count;
+        if (!get(&magic, sizeof(magic)) || magic != FILE_MAGIC || !get(&count, sizeof(count))) return;
+        for (uint32_t e = 0; e < count; ++e) {
+            Entry entry;
+            uint32_t num_bins, num_classes;
+            if (!get(&entry.fingerprint.num_processors, sizeof(uint32_t)) ||
+                !get(&entry.solution.cost, sizeof(double)) ||
+                !get(&num_bins, sizeof(num_bins))) return;
+            entry.fingerprint.histogram.resize(num_bins);
+            for (auto &[duration, jobs] : entry.fingerprint.histogram) {
+                if (!get(&duration, sizeof(uint32_t)) || !get(&jobs, sizeof(uint32_t))) return;
+            }
+            if (!get(&num_classes, sizeof(num_classes))) return;
+            entry.solution.classes.resize(num_classes);
+            entry.solution.counts.assign(num_classes, std::vector<uint32_t>(entry.fingerprint.num_processors));
+            for (uint32_t c = 0; c < num_classes; ++c) {
+                if (!get(&entry.solution.classes[c], sizeof(uint32_t)) ||
+                    !get(entry.solution.counts[c].data(), sizeof(uint32_t) * entry.fingerprint.num_processors)) return;
+            }
+            // Хэш пересчитывается по гистограмме, а не читается из файла
+            entry.fingerprint.hash = fingerprint_hash(entry.fingerprint);
+            insert_locked(std::move(entry));
+        }
+    }
+};
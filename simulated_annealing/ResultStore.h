@@ -0,0 +1,112 @@
+#pragma once
+#include "ResultCache.h"
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Хранилище результатов экспериментов: CSV, в который только дописывают. Запись — одно измерение,
+// ключ — (эксперимент, хэш экземпляра, конфигурация, зерно, сборка). Драйверы перед запуском
+// ячейки ищут ее в хранилище и пересчитывают только новые; смена бинарника меняет id сборки,
+// и старые измерения перестают находиться, оставаясь в файле для истории.
+// Конфигурация — строка "ключ=значение;..." без запятых. При повторе ключа действует последняя запись.
+//   Experiment,InstanceHash,Config,Seed,Build,Time,CpuTime,Cost,Iterations
+const std::string DEFAULT_RESULT_STORE = "experiment_store.csv";
+
+struct StoredResult {
+    double time = 0;
+    double cost = 0;
+    long long iterations = 0;
+    double cpu_time = 0;  // 0 — драйвер процессорное время не измеряет
+};
+
+// Id сборки — хэш собственного исполняемого файла; SA_BUILD_ID задает его явно, например чтобы
+// сохранить измерения после пересборки, не затронувшей решатель
+inline std::string current_build_id() {
+    if (const char *env = std::getenv("SA_BUILD_ID")) return env;
+    std::ifstream exe("/proc/self/exe", std::ios::binary);
+    if (!exe.is_open()) return "unknown";
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    char buffer[1 << 16];
+    while (exe.read(buffer, sizeof(buffer)) || exe.gcount() > 0) {
+        for (std::streamsize i = 0; i < exe.gcount(); ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 0x100000001b3ULL;
+        }
+    }
+    std::ostringstream id;
+    id << std::hex << hash;
+    return id.str();
+}
+
+inline uint64_t instance_hash(const std::vector<uint32_t> &durations, int num_processors) {
+    return make_fingerprint(durations, num_processors).hash;
+}
+
+class ResultStore {
+private:
+    std::string filename;
+    std::string build;
+    std::unordered_map<std::string, StoredResult> results;
+    std::mutex mutex;  // ячейки experiment_runner пишут из разных потоков
+
+    std::string key(const std::string &experiment, uint64_t instance, const std::string &config,
+                    unsigned int seed, const std::string &build_id) const {
+        return experiment + "," + std::to_string(instance) + "," + config + "," + std::to_string(seed) + "," +
+               build_id;
+    }
+
+public:
+    explicit ResultStore(const std::string &filename = DEFAULT_RESULT_STORE,
+                         const std::string &build = current_build_id()) :
+        filename(filename), build(build) {
+        std::ifstream file(filename);
+        std::string line;
+        std::getline(file, line);  // заголовок
+        while (std::getline(file, line)) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, ',')) fields.push_back(field);
+            if (fields.size() != 9) continue;  // оборванная последняя строка прерванного прогона
+            try {
+                StoredResult result{std::stod(fields[5]), std::stod(fields[7]), std::stoll(fields[8]),
+                                    std::stod(fields[6])};
+                results[fields[0] + "," + fields[1] + "," + fields[2] + "," + fields[3] + "," + fields[4]] = result;
+            } catch (const std::exception &) {
+                continue;
+            }
+        }
+    }
+
+    const std::string &build_id() const { return build; }
+
+    size_t size() const { return results.size(); }
+
+    std::optional<StoredResult> lookup(const std::string &experiment, uint64_t instance, const std::string &config,
+                                       unsigned int seed) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = results.find(key(experiment, instance, config, seed, build));
+        if (it == results.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Запись сразу дописывается в файл: прерванный прогон сохраняет все завершенные ячейки
+    void append(const std::string &experiment, uint64_t instance, const std::string &config, unsigned int seed,
+                const StoredResult &result) {
+        if (config.find(',') != std::string::npos) throw std::runtime_error("Result store: comma in config " + config);
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string record_key = key(experiment, instance, config, seed, build);
+        results[record_key] = result;
+        bool fresh = !std::ifstream(filename).good();
+        std::ofstream file(filename, std::ios::app);
+        if (!file.is_open()) throw std::runtime_error("Unable to open result store " + filename);
+        if (fresh) file << "Experiment,InstanceHash,Config,Seed,Build,Time,CpuTime,Cost,Iterations\n";
+        file.precision(17);
+        file << record_key << "," << result.time << "," << result.cpu_time << "," << result.cost << ","
+             << result.iterations << "\n";
+    }
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include "Solution.h"
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+// Потоковая выгрузка назначения job -> processor для диспетчера. Числа пишутся через
+// std::to_chars прямо в буфер на несколько мегабайт, который сбрасывается одним write();
+// строки на каждую работу не создаются.
+//   csv     — "job,processor" построчно;
+//   binary  — заголовок ScheduleFileHeader, затем номер процессора на каждую работу
+//             (uint16, если процессоров не больше 65536, иначе uint32);
+//   grouped — строка на процессор: "processor,load,count,job job job ...".
+enum class ScheduleFormat { Csv, Binary, Grouped };
+
+inline ScheduleFormat parse_schedule_format(const std::string &name) {
+    if (name == "csv") return ScheduleFormat::Csv;
+    if (name == "binary") return ScheduleFormat::Binary;
+    if (name == "grouped") return ScheduleFormat::Grouped;
+    throw std::runtime_error("Unknown schedule format " + name);
+}
+
+struct ScheduleFileHeader {
+    uint32_t magic = 0x31484353;  // "SCH1"
+    uint32_t index_bytes = 0;     // 2 или 4
+    uint64_t num_jobs = 0;
+    uint32_t num_processors = 0;
+    uint32_t reserved = 0;
+};
+
+class BufferedFileWriter {
+private:
+    static constexpr size_t BUFFER_SIZE = 4 << 20;
+    // Запас под одно число с разделителем, чтобы не проверять место на каждом символе
+    static constexpr size_t MAX_FIELD = 24;
+
+    int fd;
+    std::string filename;
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+
+    void write_all(const char *data, size_t size) {
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n < 0) throw std::runtime_error("Write to " + filename + " failed");
+            written += n;
+        }
+    }
+
+    void reserve(size_t size) {
+        if (used + size > BUFFER_SIZE) flush();
+    }
+
+public:
+    explicit BufferedFileWriter(const std::string &file) : filename(file), buffer(new char[BUFFER_SIZE]) {
+        fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Unable to open " + file + " for writing");
+    }
+
+    BufferedFileWriter(const BufferedFileWriter &) = delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+    ~BufferedFileWriter() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    void flush() {
+        write_all(buffer.get(), used);
+        used = 0;
+    }
+
+    void close() {
+        flush();
+        if (::close(fd) != 0) throw std::runtime_error("Closing " + filename + " failed");
+        fd = -1;
+    }
+
+    void put_bytes(const void *data, size_t size) {
+        if (size > BUFFER_SIZE) {
+            // Крупный блок уходит напрямую, минуя буфер
+            flush();
+            write_all(static_cast<const char *>(data), size);
+            return;
+        }
+        reserve(size);
+        std::memcpy(buffer.get() + used, data, size);
+        used += size;
+    }
+
+    void put_text(const char *text) { put_bytes(text, std::strlen(text)); }
+
+    template <typename Integer>
+    void put_number(Integer value, char separator) {
+        reserve(MAX_FIELD);
+        char *end = std::to_chars(buffer.get() + used, buffer.get() + used + MAX_FIELD - 1, value).ptr;
+        *end++ = separator;
+        used = end - buffer.get();
+    }
+};
+
+template <typename Index>
+void write_binary_indices(BufferedFileWriter &out, const std::vector<int> &assignment) {
+    constexpr size_t CHUNK = 1 << 16;
+    std::vector<Index> chunk(CHUNK);
+    for (size_t start = 0; start < assignment.size(); start += CHUNK) {
+        size_t count = std::min(CHUNK, assignment.size() - start);
+        for (size_t i = 0; i < count; ++i) chunk[i] = static_cast<Index>(assignment[start + i]);
+        out.put_bytes(chunk.data(), count * sizeof(Index));
+    }
+}
+
+inline void export_schedule(const SchedulingSolution &solution, const std::string &filename, ScheduleFormat format) {
+    std::vector<int> assignment = solution.get_assignment();
+    int num_processors = solution.get_num_processors();
+    BufferedFileWriter out(filename);
+
+    if (format == ScheduleFormat::Csv) {
+        out.put_text("job,processor\n");
+        for (size_t job = 0; job < assignment.size(); ++job) {
+            out.put_number(job, ',');
+            out.put_number(assignment[job], '\n');
+        }
+    } else if (format == ScheduleFormat::Binary) {
+        ScheduleFileHeader header;
+        header.index_bytes = num_processors <= 65536 ? 2 : 4;
+        header.num_jobs = assignment.size();
+        header.num_processors = num_processors;
+        out.put_bytes(&header, sizeof(header));
+        if (header.index_bytes == 2) write_binary_indices<uint16_t>(out, assignment);
+        else write_binary_indices<uint32_t>(out, assignment);
+    } else {
+        // Подсчетом: сначала размеры групп, затем номера работ по местам, без вектора на процессор
+        std::vector<size_t> offsets(num_processors + 1, 0);
+        for (int p : assignment) offsets[p + 1]++;
+        for (int p = 0; p < num_processors; ++p) offsets[p + 1] += offsets[p];
+        std::vector<int> jobs(assignment.size());
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t job = 0; job < assignment.size(); ++job) jobs[cursor[assignment[job]]++] = job;
+
+        out.put_text("processor,load,count,jobs\n");
+        for (int p = 0; p < num_processors; ++p) {
+            size_t count = offsets[p + 1] - offsets[p];
+            out.put_number(p, ',');
+            out.put_number(solution.get_processor_load(p), ',');
+            out.put_number(count, count ? ',' : '\n');
+            for (size_t i = offsets[p]; i < offsets[p + 1]; ++i) {
+                out.put_number(jobs[i], i + 1 < offsets[p + 1] ? ' ' : '\n');
+            }
+        }
+    }
+    out.close();
+}
@@ -1,16 +1,70 @@
+#pragma once
 #include "Mutation.h"
 #include "Cooling.h"
+#include <functional>
+#include <limits>
 
-class SimulatedAnnealing {
+constexpr int MAX_ITERATIONS_WITHOUT_IMPROVEMENT = 100;
+static_assert(DEFAULT_STAGNATION_LIMIT < MAX_ITERATIONS_WITHOUT_IMPROVEMENT,
+              "adaptive reheating must trigger before annealing stops on stagnation");
+
+// Порог подогрева, заданный снаружи: при пороге не меньше критерия остановки цепочка
+// останавливается раньше, чем подогрев успевает сработать
+inline void validate_stagnation_limit(int limit) {
+    if (limit < 0 || limit >= MAX_ITERATIONS_WITHOUT_IMPROVEMENT) {
+        throw std::runtime_error("Stagnation limit must be in 0.." +
+                                 std::to_string(MAX_ITERATIONS_WITHOUT_IMPROVEMENT - 1) + ", got " +
+                                 std::to_string(limit));
+    }
+}
+// Сколько принятых ходов после рекорда хранится в журнале, прежде чем рекорд копируется
+constexpr size_t BEST_JOURNAL_LIMIT = size_t(1) << 16;
+
+// Вызывается при каждом новом рекорде цепочки: номер итерации и новая стоимость
+using ProgressCallback = std::function<void(long long iteration, double cost)>;
+
+// Общий интерфейс движков поиска для параллельных драйверов: цепочка стартует с копии
+// решения, run() ищет до своего критерия остановки, лучшее найденное забирается после
+class SearchEngine {
+public:
+    virtual ~SearchEngine() = default;
+    virtual void run() = 0;
+    virtual std::shared_ptr<Solution> getLocalBestSolution() const = 0;
+    virtual long long get_iterations() const = 0;
+};
+
+// Цепочка меняет текущее решение на месте: ход применяется, а отвергнутый откатывается по
+// журналу решения, без копии на итерацию. Рекорд хранится как текущее решение плюс журнал
+// принятых с тех пор ходов: откат журнала на копии дает рекорд. Копия делается, только когда
+// рекорд запрошен или журнал превысил BEST_JOURNAL_LIMIT; после этого рекорд — готовый снимок.
+class SimulatedAnnealing : public SearchEngine {
 private:
     std::shared_ptr<Solution> solution;
-    std::shared_ptr<Solution> best_solution;
-    std::shared_ptr<Solution> local_best_solution;
+    mutable std::shared_ptr<Solution> best_solution;  // снимок рекорда; nullptr — рекорд в журнале
     Mutation* mutation;
-    TemperatureLaw* temp_law;
+    std::shared_ptr<TemperatureLaw> temp_law;
     double initial_temp;
     double temperature;
+    long long iterations = 0;
+    // Состояние пошагового режима
+    bool started = false;
+    int iter = 0;
+    int iter_no_impr = 0;
+    double current_cost = 0;
+    double best_cost = 0;
     std::mt19937 rng;
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    ProgressCallback progress;
+
+    // Рекорд = текущее решение без ходов журнала
+    void materialize_best() const {
+        auto best = solution->clone();
+        best->rollback(0);
+        best->set_journaling(false);
+        best_solution = best;
+        solution->clear_journal();
+    }
+
 public:
     SimulatedAnnealing(Solution *sol,
                        Mutation *mut,
@@ -20,45 +74,129 @@ public:
     ):
         solution(sol->clone_new_seed(seed)),
         mutation(mut),
-        temp_law(law),
+        temp_law(law->clone()),
         initial_temp(t),
         rng(seed)
     {}
 
-    void run() {
-        int iter = 0;
-        int iter_no_impr = 0;
-        double best_cost = solution->get_cost();
-        best_solution = solution->clone();
+    // Пошаговый режим: start() готовит цепочку, advance() продвигает ее на порцию итераций.
+    // run() — то же самое без ограничения бюджета.
+    void start() {
+        iter = 0;
+        iter_no_impr = 0;
+        solution->set_journaling(true);
+        current_cost = best_cost = solution->get_cost();
+        best_solution.reset();
         temperature = initial_temp;
+        started = true;
+    }
 
-        while (iter_no_impr < 100) {
-            auto new_solution = best_solution->clone();
-            mutation->apply(*new_solution);
+    // Возвращает число выполненных итераций: меньше budget, если сработал критерий остановки —
+    // MAX_ITERATIONS_WITHOUT_IMPROVEMENT итераций без нового рекорда
+    long long advance(long long budget) {
+        if (!started) start();
+        long long done = 0;
+        while (done < budget && !finished()) {
+            size_t mark = solution->journal_size();
+            mutation->apply(*solution);
 
-            double new_cost = new_solution->get_cost();
+            double new_cost = solution->get_cost();
+            double delta = new_cost - current_cost;
+            bool accepted = delta < 0 || std::exp(-delta / temperature) >= unit(rng);
+            bool new_best = accepted && new_cost < best_cost;
 
-            if (new_cost < best_cost) {
-                best_solution = new_solution;
-                best_cost = new_cost;
-                iter_no_impr = 0;
+            iter_no_impr = new_best ? 0 : iter_no_impr + 1;
+            if (!accepted) {
+                solution->rollback(mark);
             }
             else {
-                double acceptanceProbability = std::exp(-(new_cost - best_cost) / temperature);
-                if (acceptanceProbability >= static_cast<double>(rand()) / RAND_MAX) {
-                    iter_no_impr = 0;
-                    best_solution = new_solution;
+                current_cost = new_cost;
+                if (new_best) {
+                    best_cost = new_cost;
+                    best_solution.reset();
+                    solution->clear_journal();
+                    if (progress) progress(iterations + done, new_cost);
                 }
-                else {
-                    iter_no_impr++;
+                else if (best_solution) {
+                    solution->clear_journal();  // рекорд уже скопирован, журнал ему не нужен
+                }
+                else if (solution->journal_size() > BEST_JOURNAL_LIMIT) {
+                    materialize_best();
                 }
             }
+            temp_law->observe(delta, accepted, new_best);
+            if (temp_law->take_reheat()) iter_no_impr = 0;
             temperature = temp_law->get_next_temperature(iter);
             iter++;
+            done++;
         }
+        iterations += done;
+        return done;
+    }
+
+    void set_progress_callback(ProgressCallback callback) {
+        progress = std::move(callback);
     }
 
-    std::shared_ptr<Solution> getLocalBestSolution() const {
+    bool finished() const {
+        return started && iter_no_impr >= MAX_ITERATIONS_WITHOUT_IMPROVEMENT;
+    }
+
+    void run() override {
+        start();
+        advance(std::numeric_limits<long long>::max());
+    }
+
+    // Копия цепочки в том же состоянии (температура, закон охлаждения, рекорд), но со своим
+    // генератором: дальше копии расходятся
+    std::unique_ptr<SimulatedAnnealing> fork(unsigned int seed) const {
+        auto copy = std::make_unique<SimulatedAnnealing>(*this);
+        copy->temp_law = temp_law->clone();
+        copy->rng.seed(seed);
+        copy->solution = solution->clone_new_seed(seed);
+        if (best_solution) copy->best_solution = best_solution->clone();
+        return copy;
+    }
+
+    double get_best_cost() const {
+        return started ? best_cost : solution->get_cost();
+    }
+
+    // Лучшее найденное решение, а не текущее состояние цепочки
+    std::shared_ptr<Solution> getLocalBestSolution() const override {
+        if (!started) return solution;
+        if (!best_solution) materialize_best();
         return best_solution;
     }
+
+    long long get_iterations() const override {
+        return iterations;
+    }
 };
+
+// Начальная температура по выборке пробных ходов: такая, при которой средний
+// ухудшающий ход принимается с вероятностью acceptance
+inline double calibrate_temperature(const Solution &solution, Mutation &mutation,
+                                    double acceptance, int samples, unsigned int seed) {
+    double base_cost = solution.get_cost();
+    double delta_sum = 0;
+    int uphill = 0;
+    for (int i = 0; i < samples; ++i) {
+        auto candidate = solution.clone_new_seed(seed + i);
+        mutation.apply(*candidate);
+        double delta = candidate->get_cost() - base_cost;
+        if (delta > 0) {
+            delta_sum += delta;
+            uphill++;
+        }
+    }
+    if (uphill == 0) return 1.0;
+    return -(delta_sum / uphill) / std::log(acceptance);
+}
+
+inline double calibrate_temperature(AdaptiveLaw &law, const Solution &solution, Mutation &mutation,
+                                    int samples = 100, unsigned int seed = 1) {
+    double temp = calibrate_temperature(solution, mutation, law.get_initial_acceptance(), samples, seed);
+    law.set_temperature(temp);
+    return temp;
+}
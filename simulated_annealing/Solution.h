@@ -1,8 +1,12 @@
+#pragma once
 #include <iostream>
 #include <random>
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <cstdint>
+#include <limits>
+#include "LoadKernels.h"
 
 class Solution {
 public:
@@ -10,23 +14,92 @@ public:
     virtual void print() const = 0;
     virtual std::shared_ptr<Solution> clone_new_seed(unsigned int seed) const = 0;
     virtual std::shared_ptr<Solution> clone() const = 0;
+
+    // Журнал ходов: при включенной записи каждое изменение запоминается, и rollback(mark)
+    // отменяет все изменения после отметки mark = journal_size(). Выключение очищает журнал.
+    virtual void set_journaling(bool enabled) = 0;
+    virtual size_t journal_size() const = 0;
+    virtual void rollback(size_t mark) = 0;
+    virtual void clear_journal() = 0;
 };
 
+// Интерфейс расписания, общий для всех ширин длительностей и загрузок. Мутации, доводка
+// и драйверы работают через него; наружу длительности и загрузки отдаются как int64_t.
 class SchedulingSolution : public Solution {
+public:
+    virtual std::mt19937 &get_rng() = 0;
+    virtual std::uniform_int_distribution<int> &get_distribution() = 0;
+    virtual int get_num_processors() const = 0;
+    virtual int get_num_jobs() const = 0;
+    virtual int64_t get_job_time(int job_index) const = 0;
+    virtual int64_t get_processor_load(int processor) const = 0;
+    virtual int get_most_loaded_processor() const = 0;
+    virtual int get_least_loaded_processor() const = 0;
+    virtual int64_t get_total_load() const = 0;
+    virtual std::vector<int> get_assignment() const = 0;
+    virtual void set_assignment(const std::vector<int> &assignment) = 0;
+    virtual int get_job_processor(int job_index) const = 0;
+    virtual void update_schedule(int job_index, int old_processor, int new_processor) = 0;
+
+    // Нижняя оценка K1: при некратной сумме загрузки не могут совпасть
+    double get_lower_bound() const {
+        return get_total_load() % get_num_processors() == 0 ? 0.0 : 1.0;
+    }
+
+    // Длительности всех работ в общем широком виде
+    std::vector<uint32_t> get_job_times() const {
+        std::vector<uint32_t> times(get_num_jobs());
+        for (int i = 0; i < get_num_jobs(); ++i) {
+            times[i] = static_cast<uint32_t>(get_job_time(i));
+        }
+        return times;
+    }
+};
+
+// Длительности без владения: вектор или чужая память (например, отображенный сегмент
+// разделяемой памяти), из которых решение строит собственную копию в узком типе
+struct DurationView {
+    const uint32_t *data = nullptr;
+    size_t size = 0;
+
+    DurationView(const uint32_t *data, size_t size) : data(data), size(size) {}
+    DurationView(const std::vector<uint32_t> &times) : data(times.data()), size(times.size()) {}
+
+    const uint32_t *begin() const { return data; }
+    const uint32_t *end() const { return data + size; }
+};
+
+// Duration — тип длительности (uint8_t/uint16_t/uint32_t), Load — тип загрузки (int32_t/int64_t)
+template <typename Duration, typename Load>
+class BasicSchedulingSolution : public SchedulingSolution {
 private:
     int num_jobs;
     int num_processors;
-    std::vector<uint8_t> job_times;
+    std::vector<Duration> job_times;
     mutable std::mt19937 rng;
     std::vector<std::vector<uint8_t>> schedule;
     std::uniform_int_distribution<int> distribution;
-    std::vector<int> processor_loads;
+    std::vector<Load> processor_loads;
+
+    struct JournalEntry {
+        int job;
+        int from;
+        int to;
+    };
+    std::vector<JournalEntry> journal;
+    bool journaling = false;
+
+    void move_job(int job_index, int old_processor, int new_processor) {
+        schedule[job_index][old_processor] = 0;
+        schedule[job_index][new_processor] = 1;
+        processor_loads[old_processor] -= job_times[job_index];
+        processor_loads[new_processor] += job_times[job_index];
+    }
 
 public:
-    SchedulingSolution(int jobs, int processors,
-                       std::vector<uint8_t> &times, unsigned int seed) :
-                       num_jobs(jobs), num_processors(processors),
-                       job_times(times), distribution(0, processors - 1){
+    BasicSchedulingSolution(int jobs, int processors, DurationView times, unsigned int seed) :
+                            num_jobs(jobs), num_processors(processors),
+                            job_times(times.begin(), times.end()), distribution(0, processors - 1){
         rng.seed(seed);
         schedule.resize(num_jobs, std::vector<uint8_t>(num_processors, 0));
         processor_loads.resize(num_processors, 0);
@@ -38,17 +111,16 @@ public:
     }
 
     double get_cost() const override {
-        int Tmax = *std::max_element(processor_loads.begin(), processor_loads.end());
-        int Tmin = *std::min_element(processor_loads.begin(), processor_loads.end());
-        return static_cast<double>(Tmax - Tmin);
+        auto extremes = load_kernels::minmax(processor_loads.data(), processor_loads.size());
+        return static_cast<double>(extremes.max - extremes.min);
     }
 
     std::shared_ptr<Solution> clone() const override {
-        return std::make_shared<SchedulingSolution>(*this);
+        return std::make_shared<BasicSchedulingSolution>(*this);
     }
 
     std::shared_ptr<Solution> clone_new_seed(unsigned int seed) const override {
-        auto cloned = std::make_shared<SchedulingSolution>(*this);
+        auto cloned = std::make_shared<BasicSchedulingSolution>(*this);
         cloned->rng.seed(seed);
         cloned->distribution = std::uniform_int_distribution<int>(0, num_processors - 1);
         return cloned;
@@ -56,19 +128,56 @@ public:
 
     void print() const override{
         for (int i = 0; i < num_processors; ++i) {
-            std::cout << "Processor " << i << ": Load = " << processor_loads[i] << std::endl;
+            std::cout << "Processor " << i << ": Load = " << processor_loads[i] << '\n';
         }
+        std::cout.flush();
     }
 
-    std::mt19937 &get_rng() { return rng; }
+    std::mt19937 &get_rng() override { return rng; }
+
+    std::uniform_int_distribution<int> &get_distribution() override { return distribution; }
 
-    std::uniform_int_distribution<int> &get_distribution() { return distribution; }
+    int get_num_processors() const override { return num_processors; }
 
-    int get_num_processors() const { return num_processors; }
+    int get_num_jobs() const override { return num_jobs; }
 
-    int get_num_jobs() const { return num_jobs; }
+    int64_t get_job_time(int job_index) const override { return job_times[job_index]; }
 
-    int get_job_processor(int job_index) const {
+    int64_t get_processor_load(int processor) const override { return processor_loads[processor]; }
+
+    int get_most_loaded_processor() const override {
+        return load_kernels::argmax(processor_loads.data(), processor_loads.size());
+    }
+
+    int get_least_loaded_processor() const override {
+        return load_kernels::argmin(processor_loads.data(), processor_loads.size());
+    }
+
+    int64_t get_total_load() const override {
+        return load_kernels::sum(processor_loads.data(), processor_loads.size());
+    }
+
+    // Назначение job -> processor одним проходом по матрице расписания
+    std::vector<int> get_assignment() const override {
+        std::vector<int> assignment(num_jobs);
+        for (int i = 0; i < num_jobs; ++i) {
+            assignment[i] = get_job_processor(i);
+        }
+        return assignment;
+    }
+
+    // Перестраивает расписание и загрузки по готовому назначению job -> processor
+    void set_assignment(const std::vector<int> &assignment) override {
+        journal.clear();  // ходы журнала к новому назначению не относятся
+        std::fill(processor_loads.begin(), processor_loads.end(), 0);
+        for (int i = 0; i < num_jobs; ++i) {
+            std::fill(schedule[i].begin(), schedule[i].end(), 0);
+            schedule[i][assignment[i]] = 1;
+            processor_loads[assignment[i]] += job_times[i];
+        }
+    }
+
+    int get_job_processor(int job_index) const override {
         for (int j = 0; j < num_processors; ++j) {
             if (schedule[job_index][j] == 1) {
                 return j;
@@ -77,10 +186,55 @@ public:
         return -1;
     }
 
-    void update_schedule(int job_index, int old_processor, int new_processor) {
-        schedule[job_index][old_processor] = 0;
-        schedule[job_index][new_processor] = 1;
-        processor_loads[old_processor] -= job_times[job_index];
-        processor_loads[new_processor] += job_times[job_index];
+    void update_schedule(int job_index, int old_processor, int new_processor) override {
+        move_job(job_index, old_processor, new_processor);
+        if (journaling) journal.push_back({job_index, old_processor, new_processor});
     }
+
+    void set_journaling(bool enabled) override {
+        journaling = enabled;
+        journal.clear();
+    }
+
+    size_t journal_size() const override { return journal.size(); }
+
+    void rollback(size_t mark) override {
+        while (journal.size() > mark) {
+            const JournalEntry &entry = journal.back();
+            move_job(entry.job, entry.to, entry.from);
+            journal.pop_back();
+        }
+    }
+
+    void clear_journal() override { journal.clear(); }
 };
+
+template <typename Duration>
+std::shared_ptr<SchedulingSolution> make_scheduling_solution_with(int jobs, int processors,
+                                                                  DurationView times, unsigned int seed,
+                                                                  bool wide_loads) {
+    if (wide_loads) {
+        return std::make_shared<BasicSchedulingSolution<Duration, int64_t>>(jobs, processors, times, seed);
+    }
+    return std::make_shared<BasicSchedulingSolution<Duration, int32_t>>(jobs, processors, times, seed);
+}
+
+// Выбирает самые узкие типы, в которые помещается экземпляр: длительность — по максимальной
+// работе, загрузка — по сумме всех работ (ее не превысит ни один процессор)
+inline std::shared_ptr<SchedulingSolution> make_scheduling_solution(int jobs, int processors, DurationView times,
+                                                                    unsigned int seed) {
+    uint32_t longest = 0;
+    uint64_t total = 0;
+    for (uint32_t t : times) {
+        longest = std::max(longest, t);
+        total += t;
+    }
+    bool wide_loads = total > static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+    if (longest <= std::numeric_limits<uint8_t>::max()) {
+        return make_scheduling_solution_with<uint8_t>(jobs, processors, times, seed, wide_loads);
+    }
+    if (longest <= std::numeric_limits<uint16_t>::max()) {
+        return make_scheduling_solution_with<uint16_t>(jobs, processors, times, seed, wide_loads);
+    }
+    return make_scheduling_solution_with<uint32_t>(jobs, processors, times, seed, wide_loads);
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "CoroutineChains.h"
+#include <barrier>
+
+// Одна цепочка отжига с опережающей оценкой ходов. Цепочка набирает пачку из speculation
+// предложений; вспомогательные потоки параллельно считают для каждого новые загрузки двух
+// затронутых процессоров и максимум/минимум остальных на начало пачки. Затем цепочка по порядку
+// принимает решения. Оценка хода остается верной, пока ранее принятые в этой пачке ходы не
+// меняли ни один из процессоров, которые она читала (from, to и крайние среди остальных);
+// такие ходы проходят обычную проверку Метрополиса, остальные отбрасываются без счета итерации.
+// При низкой температуре почти все ходы отклоняются, и пачка целиком остается в силе.
+struct SpeculativeConfig {
+    int helpers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    int speculation = 8;               // предложений в пачке
+    long long iterations = 1000000;
+    long long max_no_improvement = 200000;
+    unsigned int seed = 1;
+};
+
+struct SpeculativeResult {
+    std::shared_ptr<SchedulingSolution> best;
+    long long iterations = 0;   // проверенные Метрополисом ходы
+    long long discarded = 0;    // оценки, устаревшие из-за принятых ходов
+    long long batches = 0;
+    double seconds = 0;
+};
+
+class SpeculativeChain {
+private:
+    struct Proposal {
+        int job;
+        int from, to;
+        int64_t new_from, new_to;
+        int64_t rest_max, rest_min;   // по процессорам, кроме from и to
+        int rest_max_proc, rest_min_proc;
+    };
+
+    const SpeculativeConfig config;
+    std::shared_ptr<TemperatureLaw> law;
+    std::vector<uint32_t> durations;
+    int num_jobs;
+    int num_processors;
+
+    std::vector<int> assignment;
+    std::vector<int> best_assignment;
+    std::vector<int64_t> loads;
+    std::vector<Proposal> batch;
+    SmallRng rng;
+    bool stop = false;
+
+    // Оценка одного предложения на загрузках начала пачки; читает только общее состояние
+    void evaluate(Proposal &p) const {
+        int64_t d = durations[p.job];
+        p.new_from = loads[p.from] - d;
+        p.new_to = loads[p.to] + d;
+        p.rest_max = INT64_MIN;
+        p.rest_min = INT64_MAX;
+        p.rest_max_proc = p.rest_min_proc = -1;
+        for (int q = 0; q < num_processors; ++q) {
+            if (q == p.from || q == p.to) continue;
+            if (loads[q] > p.rest_max) p.rest_max = loads[q], p.rest_max_proc = q;
+            if (loads[q] < p.rest_min) p.rest_min = loads[q], p.rest_min_proc = q;
+        }
+    }
+
+    void evaluate_share(int worker) {
+        for (size_t i = worker; i < batch.size(); i += config.helpers + 1) evaluate(batch[i]);
+    }
+
+    int64_t spread() const {
+        auto [lo, hi] = std::minmax_element(loads.begin(), loads.end());
+        return *hi - *lo;
+    }
+
+public:
+    SpeculativeChain(const SchedulingSolution &initial, const TemperatureLaw &law, const SpeculativeConfig &config) :
+        config(config), law(law.clone()), durations(initial.get_job_times()),
+        num_jobs(initial.get_num_jobs()), num_processors(initial.get_num_processors()),
+        assignment(initial.get_assignment()), loads(num_processors, 0) {
+        if (num_processors < 2) throw std::runtime_error("Speculative chain needs at least 2 processors");
+        if (config.speculation < 1 || config.helpers < 0) {
+            throw std::runtime_error("Speculative chain: speculation must be >= 1 and helpers >= 0");
+        }
+        for (int job = 0; job < num_jobs; ++job) loads[assignment[job]] += durations[job];
+        best_assignment = assignment;
+        rng.state = config.seed;
+    }
+
+    SpeculativeResult run() {
+        auto start = std::chrono::steady_clock::now();
+        SpeculativeResult result;
+        // Две фазы на пачку: «предложения готовы» и «оценки готовы»
+        std::barrier sync(config.helpers + 1);
+        std::vector<std::thread> helpers;
+        for (int h = 1; h <= config.helpers; ++h) {
+            helpers.emplace_back([this, h, &sync]() {
+                while (true) {
+                    sync.arrive_and_wait();
+                    if (stop) break;
+                    evaluate_share(h);
+                    sync.arrive_and_wait();
+                }
+            });
+        }
+
+        int64_t cost = spread();
+        int64_t best_cost = cost;
+        long long iter = 0;
+        long long no_improvement = 0;
+        std::vector<int> written;  // процессоры, измененные принятыми ходами текущей пачки
+        batch.resize(config.speculation);
+
+        while (iter < config.iterations && no_improvement < config.max_no_improvement && best_cost > 0) {
+            for (auto &p : batch) {
+                p.job = rng.below(num_jobs);
+                p.from = assignment[p.job];
+                p.to = rng.below(num_processors - 1);
+                if (p.to >= p.from) p.to++;
+            }
+            sync.arrive_and_wait();
+            evaluate_share(0);
+            sync.arrive_and_wait();
+            result.batches++;
+
+            written.clear();
+            for (const auto &p : batch) {
+                auto stale = [&](int q) { return std::find(written.begin(), written.end(), q) != written.end(); };
+                if (stale(p.from) || stale(p.to) || stale(p.rest_max_proc) || stale(p.rest_min_proc)) {
+                    result.discarded++;
+                    continue;
+                }
+                // Крайние среди остальных не менялись, поэтому достаточно учесть измененные процессоры
+                int64_t hi = std::max({p.new_from, p.new_to, p.rest_max});
+                int64_t lo = std::min({p.new_from, p.new_to, p.rest_min});
+                for (int q : written) {
+                    hi = std::max(hi, loads[q]);
+                    lo = std::min(lo, loads[q]);
+                }
+                int64_t candidate = hi - lo;
+                double delta = static_cast<double>(candidate - cost);
+                double temperature = law->get_next_temperature(iter);
+                bool accepted = delta <= 0 || std::exp(-delta / temperature) >= rng.unit();
+                bool new_best = accepted && candidate < best_cost;
+                law->observe(delta, accepted, new_best);
+                iter++;
+                if (accepted) {
+                    assignment[p.job] = p.to;
+                    loads[p.from] = p.new_from;
+                    loads[p.to] = p.new_to;
+                    written.push_back(p.from);
+                    written.push_back(p.to);
+                    cost = candidate;
+                }
+                if (new_best) {
+                    best_cost = candidate;
+                    best_assignment = assignment;
+                    no_improvement = 0;
+                } else if (law->take_reheat()) {
+                    no_improvement = 0;
+                } else {
+                    no_improvement++;
+                }
+            }
+        }
+
+        stop = true;
+        sync.arrive_and_wait();
+        for (auto &helper : helpers) helper.join();
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.iterations = iter;
+        result.best = make_scheduling_solution(num_jobs, num_processors, durations, config.seed);
+        result.best->set_assignment(best_assignment);
+        return result;
+    }
+};
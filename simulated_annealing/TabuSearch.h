@@ -0,0 +1,221 @@
+#pragma once
+#include "SimulatedAnnealing.h"
+#include "LargeNeighbourhood.h"
+
+// Поиск с запретами на той же окрестности, что и отжиг: перенос работы с самого загруженного
+// процессора или обмен ее с работой другого процессора. На каждой итерации оцениваются
+// candidates случайных ходов, и выполняется лучший незапрещенный, даже если он ухудшает K1.
+// Вернуть работу на процессор, с которого она ушла, запрещено на tenure итераций; запрет
+// хранится в хэш-таблице сроков (job, processor) -> итерация, проверка и запись за O(1).
+// Запрещенный ход разрешается, если дает стоимость лучше рекорда (критерий стремления).
+struct TabuConfig {
+    int candidates = 32;
+    int tenure = 10;                  // базовый срок запрета
+    int tenure_spread = 10;           // к сроку добавляется случайное 0..tenure_spread-1
+    long long max_iterations = 1000000;
+    long long max_no_improvement = 2000;
+    int table_bits = 16;              // размер хэш-таблицы запретов — 2^table_bits
+};
+
+class TabuSearch : public SearchEngine {
+private:
+    struct Move {
+        int job;
+        int other_job;  // -1 — перенос, иначе обмен
+        int from, to;
+        int64_t new_from, new_to;
+        int64_t cost;
+    };
+
+    std::shared_ptr<Solution> initial;
+    std::shared_ptr<Solution> best_solution;
+    TabuConfig config;
+    std::mt19937 rng;
+    long long iterations = 0;
+
+    std::vector<int64_t> durations;
+    std::vector<int> assignment;
+    std::vector<int64_t> loads;
+    std::vector<std::vector<int>> jobs_on;  // работы каждого процессора
+    std::vector<int> position;              // место работы в jobs_on своего процессора
+    std::vector<long long> tabu_until;
+    uint64_t table_mask;
+
+    size_t tabu_slot(int job, int processor) const {
+        uint64_t key = (static_cast<uint64_t>(job) << 32) | static_cast<uint32_t>(processor);
+        key *= 0x9e3779b97f4a7c15ULL;
+        return (key >> 32) & table_mask;
+    }
+
+    bool is_tabu(int job, int processor) const {
+        return tabu_until[tabu_slot(job, processor)] > iterations;
+    }
+
+    void forbid(int job, int processor) {
+        std::uniform_int_distribution<int> spread(0, std::max(0, config.tenure_spread - 1));
+        tabu_until[tabu_slot(job, processor)] = iterations + config.tenure + spread(rng);
+    }
+
+    void relocate(int job, int to) {
+        int from = assignment[job];
+        auto &source = jobs_on[from];
+        int last = source.back();
+        source[position[job]] = last;
+        position[last] = position[job];
+        source.pop_back();
+        position[job] = jobs_on[to].size();
+        jobs_on[to].push_back(job);
+        assignment[job] = to;
+    }
+
+    // Три наибольшие и три наименьшие загрузки: K1 после хода по двум процессорам считается за O(1)
+    struct Extremes {
+        int top[3];
+        int bottom[3];
+    };
+
+    Extremes find_extremes() const {
+        Extremes e;
+        std::fill(std::begin(e.top), std::end(e.top), -1);
+        std::fill(std::begin(e.bottom), std::end(e.bottom), -1);
+        for (int p = 0; p < static_cast<int>(loads.size()); ++p) {
+            for (int k = 0; k < 3; ++k) {
+                if (e.top[k] < 0 || loads[p] > loads[e.top[k]]) {
+                    for (int m = 2; m > k; --m) e.top[m] = e.top[m - 1];
+                    e.top[k] = p;
+                    break;
+                }
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (e.bottom[k] < 0 || loads[p] < loads[e.bottom[k]]) {
+                    for (int m = 2; m > k; --m) e.bottom[m] = e.bottom[m - 1];
+                    e.bottom[k] = p;
+                    break;
+                }
+            }
+        }
+        return e;
+    }
+
+    int64_t cost_after(const Extremes &e, int a, int b, int64_t new_a, int64_t new_b) const {
+        int64_t hi = std::max(new_a, new_b);
+        int64_t lo = std::min(new_a, new_b);
+        for (int p : e.top) {
+            if (p >= 0 && p != a && p != b) {
+                hi = std::max(hi, loads[p]);
+                break;
+            }
+        }
+        for (int p : e.bottom) {
+            if (p >= 0 && p != a && p != b) {
+                lo = std::min(lo, loads[p]);
+                break;
+            }
+        }
+        return hi - lo;
+    }
+
+public:
+    TabuSearch(Solution *sol, const TabuConfig &config, unsigned int seed) :
+        initial(sol->clone_new_seed(seed)), config(config), rng(seed) {}
+
+    void run() override {
+        auto &sched = dynamic_cast<SchedulingSolution &>(*initial);
+        int num_jobs = sched.get_num_jobs();
+        int num_processors = sched.get_num_processors();
+        durations.resize(num_jobs);
+        for (int job = 0; job < num_jobs; ++job) durations[job] = sched.get_job_time(job);
+        assignment = sched.get_assignment();
+        loads.assign(num_processors, 0);
+        jobs_on.assign(num_processors, {});
+        position.resize(num_jobs);
+        for (int job = 0; job < num_jobs; ++job) {
+            loads[assignment[job]] += durations[job];
+            position[job] = jobs_on[assignment[job]].size();
+            jobs_on[assignment[job]].push_back(job);
+        }
+        tabu_until.assign(size_t(1) << config.table_bits, 0);
+        table_mask = (uint64_t(1) << config.table_bits) - 1;
+
+        Extremes e = find_extremes();
+        int64_t cost = loads[e.top[0]] - loads[e.bottom[0]];
+        int64_t best_cost = cost;
+        std::vector<int> best_assignment = assignment;
+        int64_t lower_bound = static_cast<int64_t>(sched.get_lower_bound());
+        std::uniform_int_distribution<int> processor_dist(0, num_processors - 1);
+        long long no_improvement = 0;
+
+        while (iterations < config.max_iterations && no_improvement < config.max_no_improvement &&
+               best_cost > lower_bound && num_processors > 1) {
+            int a = e.top[0];
+            std::uniform_int_distribution<int> pick(0, jobs_on[a].size() - 1);
+            Move chosen{-1};
+            for (int c = 0; c < config.candidates; ++c) {
+                int job = jobs_on[a][pick(rng)];
+                // Половина кандидатов целится в самый свободный процессор, остальные — в случайный
+                int b = c % 2 == 0 ? e.bottom[0] : processor_dist(rng);
+                if (b == a) continue;
+                Move move{job, -1, a, b};
+                int64_t shift = durations[job];
+                if (c % 4 >= 2 && !jobs_on[b].empty()) {
+                    std::uniform_int_distribution<int> pick_other(0, jobs_on[b].size() - 1);
+                    move.other_job = jobs_on[b][pick_other(rng)];
+                    shift -= durations[move.other_job];
+                    if (shift <= 0) continue;
+                }
+                move.new_from = loads[a] - shift;
+                move.new_to = loads[b] + shift;
+                move.cost = cost_after(e, a, b, move.new_from, move.new_to);
+                bool tabu = is_tabu(job, b) || (move.other_job >= 0 && is_tabu(move.other_job, a));
+                if (tabu && move.cost >= best_cost) continue;
+                if (chosen.job < 0 || move.cost < chosen.cost) chosen = move;
+            }
+            iterations++;
+            if (chosen.job < 0) {
+                // Вся выборка под запретом: итерация пропадает, запреты тем временем истекают
+                no_improvement++;
+                continue;
+            }
+
+            relocate(chosen.job, chosen.to);
+            forbid(chosen.job, chosen.from);
+            if (chosen.other_job >= 0) {
+                relocate(chosen.other_job, chosen.from);
+                forbid(chosen.other_job, chosen.to);
+            }
+            loads[chosen.from] = chosen.new_from;
+            loads[chosen.to] = chosen.new_to;
+            cost = chosen.cost;
+            e = find_extremes();
+
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_assignment = assignment;
+                no_improvement = 0;
+            } else {
+                no_improvement++;
+            }
+        }
+
+        best_solution = initial->clone();
+        dynamic_cast<SchedulingSolution &>(*best_solution).set_assignment(best_assignment);
+    }
+
+    std::shared_ptr<Solution> getLocalBestSolution() const override {
+        return best_solution ? best_solution : initial;
+    }
+
+    long long get_iterations() const override {
+        return iterations;
+    }
+};
+
+// Движок по имени для драйверов: "sa" — отжиг с переданными мутацией и законом, "tabu" — поиск с запретами,
+// "lns" — большие окрестности с разрушением крайних процессоров (мутация не используется)
+inline std::unique_ptr<SearchEngine> make_search_engine(const std::string &name, Solution *sol, Mutation *mutation,
+                                                        TemperatureLaw *law, double temp, unsigned int seed) {
+    if (name == "sa") return std::make_unique<SimulatedAnnealing>(sol, mutation, law, temp, seed);
+    if (name == "tabu") return std::make_unique<TabuSearch>(sol, TabuConfig(), seed);
+    if (name == "lns") return std::make_unique<LnsChain>(sol, "extremes", law, temp, LnsConfig(), seed);
+    throw std::runtime_error("Unknown engine " + name + " (expected sa|tabu|lns)");
+}
@@ -0,0 +1,297 @@
+#include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "DaemonProtocol.h"
+#include "LocalSearch.h"
+#include "ResultCache.h"
+#include "ExactSolver.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <csignal>
+
+// Долгоживущий решатель: пул потоков и буферы создаются при старте, дальше демон принимает
+// экземпляры со stdin или через Unix-сокет и отвечает промежуточными рекордами и итогом.
+
+enum class WireFormat { Json, Binary };
+
+// Раундов доводки решения, взятого из кэша
+constexpr int CACHE_REFINE_ROUNDS = 3;
+// Файл кэша переписывается фоновым потоком не чаще этого интервала и только при изменениях
+constexpr auto CACHE_FLUSH_INTERVAL = std::chrono::seconds(5);
+
+volatile std::sig_atomic_t shutdown_requested = 0;
+
+class SolverDaemon {
+private:
+    ThreadPool pool;
+    std::unique_ptr<ResultCache> cache;
+    std::thread flusher;
+    std::mutex flusher_mutex;
+    std::condition_variable flusher_wake;
+    bool stopping = false;
+
+    static SolveResult make_result(const SolveRequest &request, const SchedulingSolution &best, int rounds) {
+        SolveResult result;
+        result.id = request.id;
+        result.rounds = rounds;
+        result.cost = best.get_cost();
+        result.assignment = best.get_assignment();
+        for (int p = 0; p < best.get_num_processors(); ++p) {
+            result.loads.push_back(best.get_processor_load(p));
+        }
+        return result;
+    }
+
+public:
+    SolverDaemon(size_t num_threads, size_t cache_size, const std::string &cache_file) : pool(num_threads) {
+        // Прогрев: каждый поток пула один раз проходит через отжиг маленького экземпляра
+        SolveRequest warmup;
+        warmup.num_processors = 2;
+        warmup.durations.assign(16, 1);
+        warmup.max_rounds = 1;
+        // Точный решатель взял бы такой экземпляр целиком, и потоки пула остались бы непрогретыми
+        solve(warmup, [](const SolveProgress &) {}, false);
+        // Кэш подключается после прогрева, чтобы не хранить служебный экземпляр
+        if (cache_size > 0) cache = std::make_unique<ResultCache>(cache_size, cache_file);
+        if (cache && !cache_file.empty()) {
+            flusher = std::thread([this]() {
+                std::unique_lock<std::mutex> lock(flusher_mutex);
+                while (!flusher_wake.wait_for(lock, CACHE_FLUSH_INTERVAL, [this]() { return stopping; })) {
+                    cache->flush();
+                }
+            });
+        }
+    }
+
+    ~SolverDaemon() {
+        {
+            std::lock_guard<std::mutex> lock(flusher_mutex);
+            stopping = true;
+        }
+        flusher_wake.notify_all();
+        if (flusher.joinable()) flusher.join();
+        flush_cache();
+    }
+
+    void flush_cache() {
+        if (cache) cache->flush();
+    }
+
+    SolveResult solve(const SolveRequest &request, const std::function<void(const SolveProgress &)> &emit,
+                      bool allow_exact = true) {
+        auto start = std::chrono::steady_clock::now();
+        const std::vector<uint32_t> &durations = request.durations;
+        int num_jobs = durations.size();
+        int num_threads = request.threads > 0 ? request.threads : pool.size();
+
+        SchedulingMutation mutation;
+        std::shared_ptr<TemperatureLaw> law = make_temperature_law(
+            request.law, 100.0, request.stagnation >= 0 ? request.stagnation : DEFAULT_STAGNATION_LIMIT);
+        auto initial = make_scheduling_solution(num_jobs, request.num_processors, durations, request.id);
+
+        InstanceFingerprint fingerprint;
+        int max_rounds = request.max_rounds;
+        bool cache_hit = false;
+        if (cache) {
+            fingerprint = make_fingerprint(durations, request.num_processors);
+            if (auto hit = cache->lookup(fingerprint)) {
+                cache_hit = true;
+                initial->set_assignment(hit->to_assignment(durations));
+                if (!request.refine) {
+                    SolveResult result = make_result(request, *initial, 0);
+                    result.cached = true;
+                    result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                    return result;
+                }
+                max_rounds = std::min(max_rounds, CACHE_REFINE_ROUNDS);
+            }
+        }
+        std::shared_ptr<Solution> global_best = initial;
+        // Малые экземпляры при M <= 3 решаются точно; кэш при этом пополняется как обычно
+        if (!cache_hit && allow_exact) {
+            if (auto exact = solve_exact(durations, request.num_processors, request.id)) {
+                global_best = exact;
+                max_rounds = 0;
+            }
+        }
+
+        int round = 0;
+        int stale = 0;
+        while (round < max_rounds && stale < request.stale_rounds) {
+            std::vector<std::future<std::shared_ptr<Solution>>> futures;
+            for (int i = 0; i < num_threads; ++i) {
+                unsigned int seed = derive_seed(request.id, round, i);
+                futures.push_back(pool.submit([&, seed]() {
+                    SimulatedAnnealing sa(global_best.get(), &mutation, law.get(), 100.0, seed);
+                    sa.run();
+                    return sa.getLocalBestSolution();
+                }));
+            }
+            std::shared_ptr<Solution> round_best = global_best;
+            for (auto &future : futures) {
+                auto local_best = future.get();
+                if (local_best->get_cost() < round_best->get_cost()) round_best = local_best;
+            }
+            stale = round_best == global_best ? stale + 1 : 0;
+            global_best = round_best;
+            round++;
+            emit({request.id, round, global_best->get_cost()});
+        }
+
+        // Доводка итогового решения дешевле еще одного раунда отжига
+        global_best = global_best->clone();
+        polish_solution(*global_best);
+        auto &best = dynamic_cast<SchedulingSolution &>(*global_best);
+        SolveResult result = make_result(request, best, round);
+        result.cached = cache_hit;
+        if (cache) {
+            cache->store(fingerprint, ClassAssignment::from_assignment(durations, result.assignment,
+                                                                       request.num_processors, result.cost));
+        }
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Обслуживание одного потока запросов (stdin или соединение) до его закрытия
+    void serve(int in_fd, int out_fd, WireFormat format) {
+        std::string out;
+        out.resize(1 << 20);  // буфер ответов заранее отображен в память
+        out.clear();
+        std::string pending;
+        char chunk[65536];
+
+        auto flush = [&]() {
+            write_all(out_fd, out.data(), out.size());
+            out.clear();
+        };
+
+        while (true) {
+            SolveRequest request;
+            std::string error;
+            bool ok;
+            if (format == WireFormat::Binary) {
+                ok = read_binary_request(in_fd, request, error);
+                if (!ok && error.empty()) return;
+            } else {
+                size_t newline;
+                while ((newline = pending.find('\n')) == std::string::npos) {
+                    ssize_t got = read(in_fd, chunk, sizeof(chunk));
+                    if (got < 0 && errno == EINTR && shutdown_requested) return;
+                    if (got < 0 && errno == EINTR) continue;
+                    if (got <= 0) {
+                        if (pending.empty()) return;
+                        newline = pending.size();
+                        pending += '\n';
+                        break;
+                    }
+                    pending.append(chunk, got);
+                }
+                std::string line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                ok = parse_json_request(line, request, error);
+            }
+            if (ok && (request.num_processors < 1 || request.num_processors > 65535 || request.durations.empty())) {
+                ok = false;
+                error = "invalid processors or empty durations";
+            }
+            if (ok && request.stagnation >= MAX_ITERATIONS_WITHOUT_IMPROVEMENT) {
+                ok = false;
+                error = "stagnation must be below " + std::to_string(MAX_ITERATIONS_WITHOUT_IMPROVEMENT);
+            }
+            if (!ok) {
+                if (format == WireFormat::Json) append_json_error(out, request.id, error);
+                else append_binary_frame(out, ERROR_MAGIC, request.id, 0, 0, 0);
+                flush();
+                if (format == WireFormat::Binary) return;  // поток кадров рассинхронизирован
+                continue;
+            }
+
+            try {
+                SolveResult result = solve(request, [&](const SolveProgress &progress) {
+                    if (format == WireFormat::Json) append_json_progress(out, progress);
+                    else append_binary_frame(out, PROGRESS_MAGIC, progress.id, progress.cost, progress.round, 0);
+                    flush();
+                });
+                if (format == WireFormat::Json) append_json_result(out, result);
+                else append_binary_frame(out, FINAL_MAGIC, result.id, result.cost, result.rounds,
+                                         result.elapsed_ms, result.assignment,
+                                         result.cached ? RESPONSE_FLAG_CACHED : 0);
+            } catch (const std::exception &e) {
+                if (format == WireFormat::Json) append_json_error(out, request.id, e.what());
+                else append_binary_frame(out, ERROR_MAGIC, request.id, 0, 0, 0);
+            }
+            flush();
+        }
+    }
+};
+
+int main(int argc, char *argv[]) {
+    try {
+        size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::string socket_path;
+        size_t cache_size = 0;
+        std::string cache_file;
+        WireFormat format = WireFormat::Json;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) num_threads = std::stoi(argv[++i]);
+            else if (arg == "--socket" && i + 1 < argc) socket_path = argv[++i];
+            else if (arg == "--cache-size" && i + 1 < argc) cache_size = std::stoul(argv[++i]);
+            else if (arg == "--cache-file" && i + 1 < argc) cache_file = argv[++i];
+            else if (arg == "--format" && i + 1 < argc) {
+                std::string value = argv[++i];
+                if (value == "json") format = WireFormat::Json;
+                else if (value == "binary") format = WireFormat::Binary;
+                else throw std::runtime_error("Unknown format " + value);
+            }
+            else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--threads N] [--socket path] [--format json|binary]"
+                          << " [--cache-size N] [--cache-file path]" << std::endl;
+                return 1;
+            }
+        }
+
+        // Отключившийся клиент не должен ронять демон
+        std::signal(SIGPIPE, SIG_IGN);
+        // SIGINT/SIGTERM прерывают ожидание (без SA_RESTART), и демон выходит, сохранив кэш
+        struct sigaction stop = {};
+        stop.sa_handler = [](int) { shutdown_requested = 1; };
+        sigemptyset(&stop.sa_mask);
+        sigaction(SIGINT, &stop, nullptr);
+        sigaction(SIGTERM, &stop, nullptr);
+        // Файл кэша без размера подразумевает кэш по умолчанию
+        if (!cache_file.empty() && cache_size == 0) cache_size = 64;
+        SolverDaemon daemon(num_threads, cache_size, cache_file);
+        if (socket_path.empty()) {
+            daemon.serve(STDIN_FILENO, STDOUT_FILENO, format);
+            return 0;
+        }
+
+        int listener = listen_unix(socket_path, 16);
+        std::cerr << "Listening on " << socket_path << " with " << num_threads << " threads" << std::endl;
+        while (true) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR && !shutdown_requested) continue;
+                break;
+            }
+            std::thread([&daemon, client, format]() {
+                daemon.serve(client, client, format);
+                close(client);
+            }).detach();
+        }
+        close(listener);
+        unlink(socket_path.c_str());
+        // Соединения обслуживаются отсоединенными потоками, поэтому объект демона не разрушается:
+        // кэш сохраняется явно, и процесс завершается сразу
+        daemon.flush_cache();
+        std::exit(0);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,361 @@
+#include "TabuSearch.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+#include "Instances.h"
+#include "Affinity.h"
+#include "ResultStore.h"
+#include "load_CSV.cpp"
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <tuple>
+
+// Сетка экспериментов из конфигурационного файла. Ячейка — (jobs, processors, threads, law,
+// повтор); независимые ячейки выполняются параллельно, каждая на своей группе ядер.
+// Формат файла: строки "ключ = значение", списки через запятую, # — комментарий.
+//   jobs = 4000,16000        processors = 10,40       threads = 1
+//   laws = boltzmann         repetitions = 5          seed = 42
+//   rounds = 1               temperature = 1000       parallel_cells = 0 (0 — по числу ядер)
+//   instance_seed = 7        results = grid_runs.csv  summary = heatmap_data.csv
+//   engine = sa (sa|tabu|lns)   rules = solver_rules.csv (таблица для анализатора, пусто — не писать)
+//   store = experiment_store.csv (уже измеренные этой сборкой ячейки не пересчитываются; пусто — без хранилища)
+//   stagnation = 90 (ходов без рекорда до подогрева адаптивного закона, 0 — без подогрева)
+
+struct ExperimentConfig {
+    std::vector<int> jobs = {4000, 16000, 64000, 128000, 256000};
+    std::vector<int> processors = {10, 40, 160, 640};
+    std::vector<int> threads = {1};
+    std::vector<std::string> laws = {"boltzmann"};
+    int repetitions = 5;
+    unsigned int seed = 42;
+    int rounds = 1;
+    double temperature = 1000.0;
+    int parallel_cells = 0;
+    unsigned int instance_seed = DEFAULT_INSTANCE_SEED;
+    std::string results = "grid_runs.csv";
+    std::string summary = "heatmap_data.csv";
+    std::string engine = "sa";
+    std::string rules;
+    std::string store = DEFAULT_RESULT_STORE;
+    int stagnation = DEFAULT_STAGNATION_LIMIT;
+};
+
+struct Cell {
+    int jobs;
+    int processors;
+    int threads;
+    std::string law;
+    int repetition;
+    unsigned int seed;
+};
+
+struct CellResult {
+    double time = 0;      // стена, секунды
+    double cpu_time = 0;  // сумма процессорного времени потоков ячейки
+    double cost = 0;
+    long long iterations = 0;
+};
+
+std::vector<std::string> split_list(const std::string &text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(" \t"));
+        item.erase(item.find_last_not_of(" \t") + 1);
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+std::vector<int> split_int_list(const std::string &text) {
+    std::vector<int> values;
+    for (const auto &item : split_list(text)) values.push_back(std::stoi(item));
+    return values;
+}
+
+ExperimentConfig load_config(const std::string &filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open config " + filename);
+    }
+    ExperimentConfig config;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        size_t eq = line.find('=');
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        if (eq == std::string::npos) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": expected key = value");
+        }
+        std::string key = split_list(line.substr(0, eq)).at(0);
+        std::string value = line.substr(eq + 1);
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+
+        if (key == "jobs") config.jobs = split_int_list(value);
+        else if (key == "processors") config.processors = split_int_list(value);
+        else if (key == "threads") config.threads = split_int_list(value);
+        else if (key == "laws") config.laws = split_list(value);
+        else if (key == "repetitions") config.repetitions = std::stoi(value);
+        else if (key == "seed") config.seed = std::stoul(value);
+        else if (key == "rounds") config.rounds = std::stoi(value);
+        else if (key == "temperature") config.temperature = std::stod(value);
+        else if (key == "parallel_cells") config.parallel_cells = std::stoi(value);
+        else if (key == "instance_seed") config.instance_seed = std::stoul(value);
+        else if (key == "results") config.results = value;
+        else if (key == "summary") config.summary = value;
+        else if (key == "engine") config.engine = value;
+        else if (key == "rules") config.rules = value;
+        else if (key == "store") config.store = value;
+        else if (key == "stagnation") {
+            config.stagnation = std::stoi(value);
+            try {
+                validate_stagnation_limit(config.stagnation);
+            } catch (const std::exception &e) {
+                throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": " + e.what());
+            }
+        }
+        else throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": unknown key " + key);
+
+        // Пустой список дал бы пустую сетку и пустой пул (max_element по пустому threads)
+        bool empty_list = (key == "jobs" && config.jobs.empty()) || (key == "processors" && config.processors.empty()) ||
+                          (key == "threads" && config.threads.empty()) || (key == "laws" && config.laws.empty());
+        if (empty_list) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": " + key +
+                                     " must list at least one value");
+        }
+        auto positive = [](const std::vector<int> &values) {
+            return std::all_of(values.begin(), values.end(), [](int v) { return v > 0; });
+        };
+        if ((key == "jobs" && !positive(config.jobs)) || (key == "processors" && !positive(config.processors)) ||
+            (key == "threads" && !positive(config.threads))) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": " + key +
+                                     " values must be positive");
+        }
+    }
+    return config;
+}
+
+double thread_cpu_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Ячейка: rounds раундов по threads цепочек от общего рекорда, как в main.cpp.
+// При threads = 1 и rounds = 1 — ровно один последовательный отжиг, как в measure_sequential_time.
+CellResult run_cell(const ExperimentConfig &config, const Cell &cell, const std::vector<uint32_t> &base) {
+    std::vector<uint32_t> job_times = make_instance(base, cell.jobs, config.instance_seed);
+    SchedulingMutation mutation;
+    std::shared_ptr<TemperatureLaw> law = make_temperature_law(cell.law, config.temperature, config.stagnation);
+    std::shared_ptr<Solution> best = make_scheduling_solution(cell.jobs, cell.processors, job_times, cell.seed);
+    double temperature = config.temperature;
+    if (auto adaptive = std::dynamic_pointer_cast<AdaptiveLaw>(law)) {
+        temperature = calibrate_temperature(*adaptive, *best, mutation);
+    }
+
+    CellResult result;
+    std::vector<double> cpu(cell.threads, 0);
+    std::vector<long long> iterations(cell.threads, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < config.rounds; ++round) {
+        std::vector<std::shared_ptr<Solution>> local(cell.threads);
+        auto chain = [&](int i) {
+            double cpu_start = thread_cpu_seconds();
+            auto engine = make_search_engine(config.engine, best.get(), &mutation, law.get(), temperature,
+                                             derive_seed(cell.seed, round, i));
+            engine->run();
+            local[i] = engine->getLocalBestSolution();
+            iterations[i] += engine->get_iterations();
+            cpu[i] += thread_cpu_seconds() - cpu_start;
+        };
+        if (cell.threads == 1) {
+            chain(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (int i = 0; i < cell.threads; ++i) workers.emplace_back(chain, i);
+            for (auto &worker : workers) worker.join();
+        }
+        for (const auto &candidate : local) {
+            if (candidate->get_cost() < best->get_cost()) best = candidate;
+        }
+    }
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int i = 0; i < cell.threads; ++i) {
+        result.cpu_time += cpu[i];
+        result.iterations += iterations[i];
+    }
+    result.cost = best->get_cost();
+    return result;
+}
+
+using GroupSamples = std::map<std::tuple<int, int, int, std::string>,
+                                std::pair<std::vector<double>, std::vector<double>>>;
+
+// Таблица правил для InstanceAnalyzer.h: для каждой пары (jobs, processors) сетки — потоки и закон
+// с наименьшей медианой K1, при равенстве — с наименьшей медианой времени. Бюджет — удвоенная
+// верхняя граница доверительного интервала времени. Строки идут по возрастанию размеров, так что
+// первое подходящее правило — ближайшая сверху ячейка сетки.
+void write_solver_rules(const ExperimentConfig &config, const GroupSamples &groups) {
+    struct Pick {
+        int threads;
+        std::string law;
+        double cost;
+        double time;
+        double time_high;
+    };
+    std::map<std::pair<int, int>, Pick> best;
+    for (const auto &[key, samples] : groups) {
+        SampleStats time = summarize(samples.first);
+        Pick pick{std::get<2>(key), std::get<3>(key), median_of(samples.second), time.median, time.ci_high};
+        auto [it, inserted] = best.try_emplace({std::get<0>(key), std::get<1>(key)}, pick);
+        Pick &current = it->second;
+        if (!inserted && (pick.cost < current.cost || (pick.cost == current.cost && pick.time < current.time))) {
+            current = pick;
+        }
+    }
+    char date[16];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+    std::ofstream rules(config.rules);
+    rules << "MaxJobs,MaxProcessors,MaxDuration,Engine,Law,Threads,Budget,Source" << std::endl;
+    for (const auto &[size, pick] : best) {
+        double budget = std::max(1.0, std::ceil(2 * pick.time_high));
+        rules << size.first << "," << size.second << ",0," << config.engine << "," << pick.law << ","
+              << pick.threads << "," << budget << "," << config.results << " " << date << "\n";
+    }
+}
+
+// Ключ ячейки в хранилище: все параметры, от которых зависит результат, кроме зерна
+std::string cell_config_key(const ExperimentConfig &config, const Cell &cell) {
+    std::ostringstream key;
+    key << "jobs=" << cell.jobs << ";processors=" << cell.processors << ";threads=" << cell.threads
+        << ";law=" << cell.law << ";engine=" << config.engine << ";rounds=" << config.rounds
+        << ";temperature=" << config.temperature << ";instance_seed=" << config.instance_seed
+        << ";stagnation=" << config.stagnation;
+    return key.str();
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        if (argc != 2) {
+            std::cerr << "Usage: " << argv[0] << " <config file>" << std::endl;
+            return 1;
+        }
+        ExperimentConfig config = load_config(argv[1]);
+        std::vector<uint32_t> base = load_jobs("jobs.csv");
+
+        std::vector<Cell> cells;
+        for (int jobs : config.jobs)
+            for (int processors : config.processors)
+                for (int threads : config.threads)
+                    for (const auto &law : config.laws)
+                        for (int rep = 0; rep < config.repetitions; ++rep)
+                            cells.push_back({jobs, processors, threads, law, rep, config.seed + rep});
+
+        // Резерв ядер на ячейку — наибольшее число потоков в сетке
+        int reservation = *std::max_element(config.threads.begin(), config.threads.end());
+        CoreReservations reservations(available_cores(), reservation);
+        size_t parallel = reservations.size();
+        if (config.parallel_cells > 0) parallel = std::min<size_t>(parallel, config.parallel_cells);
+        std::cout << "Cells: " << cells.size() << ", running " << parallel << " at a time, "
+                  << reservation << " core(s) reserved per cell\n";
+
+        // Сначала самые тяжелые ячейки, чтобы хвост сетки не ждал одну большую
+        std::vector<size_t> order(cells.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return static_cast<long long>(cells[a].jobs) * cells[a].processors * cells[a].threads >
+                   static_cast<long long>(cells[b].jobs) * cells[b].processors * cells[b].threads;
+        });
+
+        std::unique_ptr<ResultStore> store;
+        if (!config.store.empty()) store = std::make_unique<ResultStore>(config.store);
+        std::atomic<int> stored_cells{0};
+
+        std::vector<CellResult> results(cells.size());
+        std::mutex print_mutex;
+        auto grid_start = std::chrono::steady_clock::now();
+        {
+            ThreadPool pool(parallel);
+            std::vector<std::future<void>> futures;
+            for (size_t index : order) {
+                futures.push_back(pool.submit([&, index]() {
+                    const Cell &cell = cells[index];
+                    uint64_t instance = 0;
+                    std::string key;
+                    std::optional<StoredResult> stored;
+                    if (store) {
+                        instance = instance_hash(make_instance(base, cell.jobs, config.instance_seed), cell.processors);
+                        key = cell_config_key(config, cell);
+                        stored = store->lookup("grid", instance, key, cell.seed);
+                    }
+                    if (stored) {
+                        results[index] = {stored->time, stored->cpu_time, stored->cost, stored->iterations};
+                        stored_cells++;
+                    } else {
+                        int group = reservations.acquire();
+                        pin_current_thread(reservations.cores(group));
+                        results[index] = run_cell(config, cell, base);
+                        reservations.release(group);
+                        const CellResult &r = results[index];
+                        if (store) {
+                            store->append("grid", instance, key, cell.seed, {r.time, r.cost, r.iterations, r.cpu_time});
+                        }
+                    }
+                    std::lock_guard<std::mutex> lock(print_mutex);
+                    std::cout << "Jobs: " << cell.jobs << ", Processors: " << cell.processors
+                              << ", Threads: " << cell.threads << ", Law: " << cell.law
+                              << ", Rep: " << cell.repetition << ", Time: " << results[index].time
+                              << "s, Cost: " << results[index].cost << std::endl;
+                }));
+            }
+            for (auto &future : futures) future.get();
+        }
+        double grid_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - grid_start).count();
+
+        std::ofstream raw(config.results);
+        raw << "Jobs,Processors,Threads,Law,Repetition,Seed,Time,CpuTime,Cost,Iterations" << std::endl;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            const Cell &c = cells[i];
+            const CellResult &r = results[i];
+            raw << c.jobs << "," << c.processors << "," << c.threads << "," << c.law << "," << c.repetition << ","
+                << c.seed << "," << r.time << "," << r.cpu_time << "," << r.cost << "," << r.iterations << "\n";
+        }
+
+        // Сводка по повторам; при одном законе и одном числе потоков совместима с plots.py
+        GroupSamples groups;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            auto &group = groups[{cells[i].jobs, cells[i].processors, cells[i].threads, cells[i].law}];
+            group.first.push_back(results[i].time);
+            group.second.push_back(results[i].cost);
+        }
+        std::ofstream summary(config.summary);
+        summary << "Jobs,Processors,Threads,Law,Time,Time_Low,Time_High,Cost" << std::endl;
+        for (const auto &[key, samples] : groups) {
+            SampleStats time = summarize(samples.first);
+            summary << std::get<0>(key) << "," << std::get<1>(key) << "," << std::get<2>(key) << ","
+                    << std::get<3>(key) << "," << time.median << "," << time.ci_low << "," << time.ci_high << ","
+                    << median_of(samples.second) << "\n";
+        }
+
+        if (!config.rules.empty()) {
+            write_solver_rules(config, groups);
+            std::cout << "Правила выбора решателя записаны в " << config.rules << "\n";
+        }
+
+        std::cout << "Grid finished in " << grid_time << "s";
+        if (store) std::cout << ", " << stored_cells << " of " << cells.size() << " cells taken from " << config.store;
+        std::cout << "\n";
+        std::cout << "Данные сохранены в " << config.results << " и " << config.summary << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "Islands.h"
+#include "load_CSV.cpp"
+#include <sys/wait.h>
+#include <poll.h>
+#include <climits>
+#include <chrono>
+#include <csignal>
+
+// Островная модель на нескольких процессах: координатор кладет экземпляр в разделяемую память,
+// рабочие процессы гоняют свои цепочки отжига и обмениваются рекордами через Unix-сокет.
+// Рабочие — отдельные процессы этого же бинарника, запущенные координатором в режиме
+//   ./islands --worker <shm_name> <socket_path> <worker_id> <seed> <law>
+
+// Сколько координатор ждет подключения всех рабочих процессов
+constexpr int WORKER_CONNECT_TIMEOUT_MS = 10000;
+
+int run_worker(const std::string &shm_name, const std::string &socket_path,
+               uint32_t worker_id, unsigned int seed, const std::string &law_name) {
+    SharedInstance instance(shm_name);
+    int num_jobs = instance.header().num_jobs;
+    int num_processors = instance.header().num_processors;
+    // Решение строится прямо по отображенному сегменту; своя копия у него только в самом узком типе
+    DurationView job_durations(instance.durations(), num_jobs);
+
+    int fd = connect_unix(socket_path);
+    send_message(fd, ISLAND_HELLO, worker_id, 0);
+
+    auto current = make_scheduling_solution(num_jobs, num_processors, job_durations, seed);
+    SchedulingMutation mutation;
+    std::shared_ptr<TemperatureLaw> law = make_temperature_law(law_name, 100.0);
+    uint64_t known_global_cost = UINT64_MAX;
+
+    for (unsigned int epoch = 0;; ++epoch) {
+        SimulatedAnnealing sa(current.get(), &mutation, law.get(), 100.0, derive_seed(seed, epoch, worker_id));
+        sa.run();
+        current = std::dynamic_pointer_cast<SchedulingSolution>(sa.getLocalBestSolution());
+
+        // Полное назначение отправляется только если оно лучше известного глобального рекорда
+        uint64_t cost = static_cast<uint64_t>(current->get_cost());
+        std::vector<uint16_t> payload;
+        if (cost < known_global_cost) payload = pack_assignment(current->get_assignment());
+        if (!send_message(fd, ISLAND_BEST, worker_id, cost, payload)) break;
+
+        IslandMessage reply;
+        if (!receive_message(fd, reply, num_jobs) || reply.header.type == ISLAND_STOP) break;
+        known_global_cost = reply.header.cost;
+        if (reply.header.count == static_cast<uint32_t>(num_jobs) &&
+            valid_assignment(reply.assignment, num_processors)) {
+            current->set_assignment(unpack_assignment(reply.assignment));
+        }
+    }
+    close(fd);
+    return 0;
+}
+
+int run_coordinator(const char *self, int num_workers, int num_processors,
+                    const std::string &law_name, int max_stale_epochs) {
+    if (num_processors < 1 || num_processors > ISLAND_MAX_PROCESSORS) {
+        throw std::runtime_error("Islands support 1.." + std::to_string(ISLAND_MAX_PROCESSORS) +
+                                 " processors, got " + std::to_string(num_processors));
+    }
+    std::vector<uint32_t> job_durations = load_jobs("jobs.csv");
+    int num_jobs = job_durations.size();
+
+    std::string suffix = std::to_string(getpid());
+    std::string shm_name = "/sa_islands_" + suffix;
+    std::string socket_path = "/tmp/sa_islands_" + suffix + ".sock";
+
+    SharedInstance instance(shm_name, job_durations, num_processors);
+    int listener = listen_unix(socket_path, num_workers);
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < num_workers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::string id = std::to_string(i);
+            std::string seed = std::to_string(derive_seed(42, 0, i));
+            execl("/proc/self/exe", self, "--worker", shm_name.c_str(), socket_path.c_str(),
+                  id.c_str(), seed.c_str(), law_name.c_str(), static_cast<char *>(nullptr));
+            _exit(127);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+
+    // Подключения ждем с тайм-аутом, попутно собирая завершившихся детей: процесс, не дошедший
+    // до HELLO (не прошел execl, упал при старте), снимается с ожидания, зависшие по тайм-ауту убиваются
+    std::vector<pollfd> workers;
+    std::vector<bool> connected(children.size(), false);
+    std::vector<bool> exited(children.size(), false);
+    size_t expected = children.size();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WORKER_CONNECT_TIMEOUT_MS);
+    while (workers.size() < expected) {
+        int status;
+        pid_t dead;
+        while ((dead = waitpid(-1, &status, WNOHANG)) > 0) {
+            size_t i = std::find(children.begin(), children.end(), dead) - children.begin();
+            if (i == children.size()) continue;
+            exited[i] = true;
+            if (!connected[i]) {
+                std::cerr << "Worker " << i << " exited before connecting (status " << status << ")" << std::endl;
+                expected--;
+            }
+        }
+        if (workers.size() >= expected) break;
+
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            std::cerr << "Timed out waiting for " << expected - workers.size() << " workers" << std::endl;
+            for (size_t i = 0; i < children.size(); ++i) {
+                if (!connected[i] && !exited[i]) kill(children[i], SIGKILL);
+            }
+            break;
+        }
+        pollfd pending = {listener, POLLIN, 0};
+        int ready = poll(&pending, 1, std::min<long long>(left.count(), 100));
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        IslandMessage hello;
+        if (!receive_message(fd, hello, 0) || hello.header.type != ISLAND_HELLO ||
+            hello.header.worker >= children.size() || connected[hello.header.worker]) {
+            close(fd);
+            expected--;
+            continue;
+        }
+        connected[hello.header.worker] = true;
+        workers.push_back({fd, POLLIN, 0});
+    }
+    close(listener);
+    unlink(socket_path.c_str());
+
+    std::vector<uint16_t> global_assignment;
+    uint64_t global_cost = UINT64_MAX;
+    long long stale_reports = 0;
+    const long long max_stale_reports = static_cast<long long>(max_stale_epochs) * std::max<size_t>(1, workers.size());
+    size_t active = workers.size();
+
+    std::cout << "Islands: " << active << " workers, jobs: " << num_jobs
+              << ", processors: " << num_processors << std::endl;
+
+    while (active > 0) {
+        if (poll(workers.data(), workers.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (auto &worker : workers) {
+            if (worker.fd < 0 || !(worker.revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            IslandMessage message;
+            bool ok = receive_message(worker.fd, message, num_jobs) && message.header.type == ISLAND_BEST;
+            if (ok && message.header.count == static_cast<uint32_t>(num_jobs) &&
+                message.header.cost < global_cost && valid_assignment(message.assignment, num_processors)) {
+                global_cost = message.header.cost;
+                global_assignment = std::move(message.assignment);
+                stale_reports = 0;
+                std::cout << "Current best solution cost: " << global_cost
+                          << " (worker " << message.header.worker << ")" << std::endl;
+            } else {
+                stale_reports++;
+            }
+
+            if (!ok || stale_reports >= max_stale_reports) {
+                if (ok) send_message(worker.fd, ISLAND_STOP, 0, global_cost);
+                close(worker.fd);
+                worker.fd = -1;
+                active--;
+                continue;
+            }
+            // Отстающий остров получает текущий рекорд, лидер — только подтверждение
+            if (message.header.cost > global_cost) {
+                send_message(worker.fd, ISLAND_BEST, 0, global_cost, global_assignment);
+            } else {
+                send_message(worker.fd, ISLAND_BEST, 0, global_cost);
+            }
+        }
+    }
+
+    for (pid_t pid : children) {
+        waitpid(pid, nullptr, 0);
+    }
+
+    if (global_assignment.empty()) {
+        std::cerr << "No worker reported a solution" << std::endl;
+        return 1;
+    }
+    auto best = make_scheduling_solution(num_jobs, num_processors, job_durations, 0);
+    best->set_assignment(unpack_assignment(global_assignment));
+    std::cout << "Current best solution cost: " << best->get_cost() << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        if (argc == 7 && std::string(argv[1]) == "--worker") {
+            return run_worker(argv[2], argv[3], std::stoul(argv[4]), std::stoul(argv[5]), argv[6]);
+        }
+        if (argc < 2 || argc > 5) {
+            std::cerr << "Usage: " << argv[0]
+                      << " <num_workers> [num_processors] [boltzmann|cauchy|logcauchy|adaptive] [stale_epochs]"
+                      << std::endl;
+            return 1;
+        }
+        int num_workers = std::stoi(argv[1]);
+        int num_processors = argc > 2 ? std::stoi(argv[2]) : 40;
+        std::string law_name = argc > 3 ? argv[3] : "cauchy";
+        int stale_epochs = argc > 4 ? std::stoi(argv[4]) : 5;
+        return run_coordinator(argv[0], num_workers, num_processors, law_name, stale_epochs);
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
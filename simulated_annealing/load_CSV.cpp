@@ -3,8 +3,13 @@
 #include <vector>
 #include <memory>
 #include <iostream>
-std::vector<uint8_t> load_jobs(const std::string &filename) {
-    std::vector<uint8_t> job_durations;
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+// Длительность, не помещающаяся в Duration, — ошибка, а не тихое усечение
+template <typename Duration = uint32_t>
+std::vector<Duration> load_jobs(const std::string &filename) {
+    std::vector<Duration> job_durations;
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Unable to open file " + filename);
@@ -24,8 +29,12 @@ std::vector<uint8_t> load_jobs(const std::string &filename) {
         std::getline(ss, job_id, ',');
         std::getline(ss, duration_str, ',');
 
-        uint8_t duration = std::stoi(duration_str);
-        job_durations.push_back(duration);
+        long long duration = std::stoll(duration_str);
+        if (duration < 0 || static_cast<unsigned long long>(duration) > std::numeric_limits<Duration>::max()) {
+            throw std::runtime_error("Duration " + duration_str + " of job " + job_id + " in " + filename +
+                                     " does not fit into " + std::to_string(sizeof(Duration) * 8) + " bits");
+        }
+        job_durations.push_back(static_cast<Duration>(duration));
     }
 
     file.close();
@@ -1,34 +1,327 @@
 #include "SimulatedAnnealing.h"
 #include "load_CSV.cpp"
+#include "PerfCounters.h"
+#include "LocalSearch.h"
+#include "ResultCache.h"
+#include "Racing.h"
+#include "Portfolio.h"
+#include "CoroutineChains.h"
+#include "Decomposition.h"
+#include "SpeculativeChain.h"
+#include "ScheduleExport.h"
+#include "TabuSearch.h"
+#include "ExactSolver.h"
+#include "LaneChains.h"
+#include "InstanceAnalyzer.h"
+#include "LargeNeighbourhood.h"
 #include <thread>
 #include <chrono>
 
 int main(int argc, char *argv[]) {
     std::shared_ptr<Solution> global_best_solution;
     try {
-        if (argc != 2) {
-            std::cerr << "Usage: " << argv[0] << " <num_threads>" << std::endl;
+        std::vector<std::string> positional;
+        bool polish = false;
+        bool refine = false;
+        bool race = false;
+        bool portfolio = false;
+        bool lns = false;
+        double portfolio_seconds = 10.0;
+        int coroutine_chains = 0;
+        int lane_chains = 0;
+        int groups = 0;
+        int speculation = 0;
+        std::string export_file;
+        std::string export_format = "csv";
+        std::string engine_name = "sa";
+        bool engine_set = false;
+        bool auto_config = false;
+        std::string rules_file = "solver_rules.csv";
+        int num_processors = 40;
+        int stagnation_limit = DEFAULT_STAGNATION_LIMIT;
+        long long race_budget = 200000;
+        std::string cache_file;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--polish") polish = true;
+            else if (arg == "--refine") refine = true;
+            else if (arg == "--cache" && i + 1 < argc) cache_file = argv[++i];
+            else if (arg == "--race") race = true;
+            else if (arg == "--portfolio") portfolio = true;
+            else if (arg == "--lns") lns = true;
+            else if (arg == "--seconds" && i + 1 < argc) portfolio_seconds = std::stod(argv[++i]);
+            else if (arg == "--chains" && i + 1 < argc) coroutine_chains = std::stoi(argv[++i]);
+            else if (arg == "--groups" && i + 1 < argc) groups = std::stoi(argv[++i]);
+            else if (arg == "--speculate" && i + 1 < argc) speculation = std::stoi(argv[++i]);
+            else if (arg == "--export" && i + 1 < argc) export_file = argv[++i];
+            else if (arg == "--format" && i + 1 < argc) export_format = argv[++i];
+            else if (arg == "--engine" && i + 1 < argc) {
+                engine_name = argv[++i];
+                engine_set = true;
+            }
+            else if (arg == "--auto") auto_config = true;
+            else if (arg == "--rules" && i + 1 < argc) rules_file = argv[++i];
+            else if (arg == "--processors" && i + 1 < argc) num_processors = std::stoi(argv[++i]);
+            else if (arg == "--lanes" && i + 1 < argc) lane_chains = std::stoi(argv[++i]);
+            else if (arg == "--budget" && i + 1 < argc) race_budget = std::stoll(argv[++i]);
+            else if (arg == "--stagnation" && i + 1 < argc) {
+                stagnation_limit = std::stoi(argv[++i]);
+                validate_stagnation_limit(stagnation_limit);
+            }
+            else positional.push_back(arg);
+        }
+        if ((positional.empty() && !auto_config) || positional.size() > 2) {
+            std::cerr << "Usage: " << argv[0] << " <num_threads> [boltzmann|cauchy|logcauchy|adaptive] [--polish]"
+                      << " [--cache file [--refine]] [--race [--budget iterations]]"
+                      << " [--portfolio [--seconds S]] [--chains N] [--groups G]"
+                      << " [--speculate K] [--export file [--format csv|binary|grouped]] [--engine sa|tabu]"
+                      << " [--processors M] [--lanes N] [--auto [--rules file]] [--lns [--seconds S]]"
+                      << " [--stagnation N]" << std::endl;
             return 1;
         }
 
-        int num_threads = std::stoi(argv[1]);
-        std::vector<uint8_t> job_durations = load_jobs("jobs.csv");
+        std::vector<uint32_t> job_durations = load_jobs("jobs.csv");
         int num_jobs = job_durations.size();
-        int num_processors = 40;
 
+        // Автовыбор: движок, закон, потоки и бюджет по признакам экземпляра; явно заданное
+        // в командной строке важнее таблицы правил
+        std::unique_ptr<InstanceFeatures> features;
+        SolverChoice choice;
+        if (auto_config) {
+            features = std::make_unique<InstanceFeatures>(analyze_instance(job_durations, num_processors));
+            choice = choose_solver(*features, load_solver_rules(rules_file));
+            log_solver_decision("solver_decisions.csv", *features, choice);
+            print_instance_features(std::cout, *features);
+            std::cout << "Solver choice (" << choice.rule << "): engine " << choice.engine << ", law " << choice.law
+                      << ", threads " << choice.threads << ", budget " << choice.budget << "s" << std::endl;
+            if (!engine_set && choice.engine != "greedy") engine_name = choice.engine;
+        }
+
+        int num_threads = !positional.empty() ? std::stoi(positional[0]) : choice.threads;
         SchedulingMutation mutationOperation;
-        BoltzmannLaw coolingSchedule(100.0);
+        std::string law_name = positional.size() == 2 ? positional[1]
+                             : auto_config && choice.engine != "greedy" ? choice.law : "boltzmann";
         double initialTemperature = 100.0;
+        std::shared_ptr<TemperatureLaw> coolingSchedule = make_temperature_law(law_name, initialTemperature,
+                                                                                   stagnation_limit);
 
         int globalNoImprovementCount = 0;
+        int maxNoImprovement = 10;
+        double time_budget = auto_config ? choice.budget : 0;  // секунды на раунды, 0 — без ограничения
 
-        
-        if (!global_best_solution) {
-            global_best_solution = std::make_shared<SchedulingSolution>(num_jobs, num_processors, job_durations, std::chrono::system_clock::now().time_since_epoch().count());
+        // Счетчики по каждому потоку (суммируются по всем раундам) и по всему решению
+        std::vector<PerfSample> thread_perf(num_threads);
+        std::vector<long long> thread_iterations(num_threads, 0);
+
+        // Одной декомпозиции полное решение (матрица N×M) не нужно: она ведет вектор назначений,
+        // а объект решения строится после нее, только если его требуют доводка или экспорт
+        bool assignment_only = groups > 0 && !race && !portfolio && !lns && coroutine_chains == 0 &&
+                               lane_chains == 0 && speculation == 0;
+        std::vector<int> assignment;
+        double assignment_best = 0;
+        auto build_solution = [&](const std::vector<int> &from) {
+            auto solution = make_scheduling_solution(num_jobs, num_processors, job_durations,
+                                                     std::chrono::system_clock::now().time_since_epoch().count());
+            solution->set_assignment(from);
+            return solution;
+        };
+
+        if (assignment_only) {
+            assignment = round_robin_assignment(num_jobs, num_processors);
+        } else if (!global_best_solution) {
+            global_best_solution = make_scheduling_solution(num_jobs, num_processors, job_durations, std::chrono::system_clock::now().time_since_epoch().count());
+        }
+
+        // Тот же набор длительностей уже решался: отдаем сохраненное решение или дорабатываем его
+        std::unique_ptr<ResultCache> cache;
+        InstanceFingerprint fingerprint = make_fingerprint(job_durations, num_processors);
+        if (!cache_file.empty()) {
+            cache = std::make_unique<ResultCache>(64, cache_file);
+            if (auto hit = cache->lookup(fingerprint)) {
+                double cached_cost;
+                if (global_best_solution) {
+                    auto &cached = dynamic_cast<SchedulingSolution &>(*global_best_solution);
+                    cached.set_assignment(hit->to_assignment(job_durations));
+                    cached_cost = cached.get_cost();
+                } else {
+                    assignment = hit->to_assignment(job_durations);
+                    cached_cost = assignment_cost(job_durations, assignment, num_processors);
+                }
+                std::cout << "Cache hit, cost: " << cached_cost << std::endl;
+                if (!refine) return 0;
+                maxNoImprovement = 2;
+            }
+        }
+
+        if (features) {
+            // Жадное расписание анализатора — стартовая точка; если оно достигает нижней оценки, это ответ
+            if (global_best_solution) {
+                global_best_solution = global_best_solution->clone();
+                dynamic_cast<SchedulingSolution &>(*global_best_solution).set_assignment(features->greedy_assignment);
+            } else {
+                assignment = features->greedy_assignment;
+            }
+            if (choice.engine == "greedy") {
+                if (!global_best_solution) global_best_solution = build_solution(assignment);
+                std::cout << "Greedy schedule meets the lower bound, cost: " << global_best_solution->get_cost()
+                          << std::endl;
+                globalNoImprovementCount = maxNoImprovement;
+                race = portfolio = lns = false;
+                coroutine_chains = lane_chains = groups = speculation = 0;
+            }
+        }
+
+        // При M <= 3 и небольшой сумме длительностей оптимум находится точно, отжиг не нужен
+        if (auto exact = solve_exact(job_durations, num_processors, 1)) {
+            std::cout << "Exact solution (bitset DP), cost: " << exact->get_cost() << std::endl;
+            global_best_solution = exact;
+            globalNoImprovementCount = maxNoImprovement;
+            race = portfolio = lns = false;
+            coroutine_chains = lane_chains = groups = speculation = 0;
+        }
+
+        if (auto adaptive = std::dynamic_pointer_cast<AdaptiveLaw>(coolingSchedule);
+            adaptive && globalNoImprovementCount < maxNoImprovement) {
+            std::shared_ptr<Solution> probe = global_best_solution ? global_best_solution
+                                            : group_sample(job_durations, assignment, num_processors, groups, 10000, 1);
+            initialTemperature = calibrate_temperature(*adaptive, *probe, mutationOperation);
+            std::cout << "Calibrated initial temperature: " << initialTemperature << std::endl;
         }
         
+        if (race) {
+            // Гонка: вчетверо больше цепочек, чем потоков, каждый этап оставляет лучшую половину
+            ThreadPool pool(num_threads);
+            RacingConfig config;
+            config.chains = 4 * num_threads;
+            config.budget = race_budget;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            AnnealingRace annealing_race(pool, mutationOperation, *coolingSchedule, initialTemperature, config);
+            RaceResult result = annealing_race.run(*global_best_solution);
+            for (int rung = 0; rung < result.rungs; ++rung) {
+                std::cout << "Rung " << rung << " best cost: " << result.rung_costs[rung] << std::endl;
+            }
+            global_best_solution = result.best;
+            thread_iterations[0] = result.iterations;
+            if (polish) {
+                global_best_solution = global_best_solution->clone();
+                polish_solution(*global_best_solution);
+            }
+            // Раунды синхронизации ниже не нужны
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        if (coroutine_chains > 0) {
+            // Тысячи легких цепочек-корутин на num_threads рабочих потоках
+            CoroutineConfig config;
+            config.chains = coroutine_chains;
+            config.workers = num_threads;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            auto &instance = dynamic_cast<SchedulingSolution &>(*global_best_solution);
+            CoroutineResult result = CoroutineChainPool(instance, *coolingSchedule, config).run();
+            std::cout << "Coroutine chains: " << config.chains << ", iterations " << result.iterations
+                      << ", state " << result.state_bytes / 1024 << " KiB, " << result.seconds << "s" << std::endl;
+            global_best_solution = result.best;
+            thread_iterations[0] = result.iterations;
+            if (polish) polish_solution(*global_best_solution);
+            globalNoImprovementCount = maxNoImprovement;
+        }
 
-        while (globalNoImprovementCount < 10) {
+        if (lane_chains > 0) {
+            // Цепочки блоками по LANES в векторных дорожках, блоки делятся между потоками
+            LaneConfig config;
+            config.chains = lane_chains;
+            config.workers = num_threads;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            auto &instance = dynamic_cast<SchedulingSolution &>(*global_best_solution);
+            LaneResult result = LaneChainPool(instance, *coolingSchedule, config).run();
+            std::cout << "Lane chains: " << result.chains << " (" << LANES << " per block, "
+                      << load_kernels::isa_name(load_kernels::active_isa()) << "), iterations "
+                      << result.iterations << ", " << result.seconds << "s" << std::endl;
+            global_best_solution = result.best;
+            thread_iterations[0] = result.iterations;
+            if (polish) polish_solution(*global_best_solution);
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        if (groups > 0) {
+            // Декомпозиция: G групп процессоров отжигаются параллельно, затем межгрупповая балансировка
+            ThreadPool pool(num_threads);
+            DecompositionConfig config;
+            config.groups = groups;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            ProcessorGroupDecomposition decomposition(pool, mutationOperation, *coolingSchedule, initialTemperature,
+                                                      config, job_durations, num_processors);
+            if (global_best_solution) assignment = dynamic_cast<SchedulingSolution &>(*global_best_solution).get_assignment();
+            DecompositionResult result = decomposition.run(assignment);
+            for (int round = 0; round < result.rounds; ++round) {
+                std::cout << "Decomposition round " << round << " cost: " << result.round_costs[round] << std::endl;
+            }
+            assignment = std::move(result.assignment);
+            assignment_best = result.cost;
+            if (global_best_solution || polish || !export_file.empty()) {
+                global_best_solution = build_solution(assignment);
+                if (polish) polish_solution(*global_best_solution);
+            }
+            thread_iterations[0] = result.iterations;
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        if (speculation > 0) {
+            // Одна цепочка; остальные потоки заранее оценивают по K ходов за пачку
+            SpeculativeConfig config;
+            config.helpers = num_threads - 1;
+            config.speculation = speculation;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            auto &instance = dynamic_cast<SchedulingSolution &>(*global_best_solution);
+            SpeculativeResult result = SpeculativeChain(instance, *coolingSchedule, config).run();
+            std::cout << "Speculative chain: " << result.iterations << " iterations in " << result.batches
+                      << " batches, " << result.discarded << " discarded, " << result.seconds << "s" << std::endl;
+            global_best_solution = result.best;
+            thread_iterations[0] = result.iterations;
+            if (polish) polish_solution(*global_best_solution);
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        if (portfolio) {
+            // Портфель сам выбирает закон и мутацию; позиционный закон игнорируется
+            ThreadPool pool(num_threads);
+            PortfolioConfig config;
+            config.seconds = portfolio_seconds;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            PortfolioResult result = PortfolioSolver(pool, config).run(*global_best_solution);
+            print_portfolio_report(std::cout, result);
+            global_best_solution = result.best;
+            if (polish) {
+                global_best_solution = global_best_solution->clone();
+                polish_solution(*global_best_solution);
+            }
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        auto rounds_start = std::chrono::steady_clock::now();
+        auto within_budget = [&]() {
+            return time_budget <= 0 ||
+                   std::chrono::duration<double>(std::chrono::steady_clock::now() - rounds_start).count() < time_budget;
+        };
+        if (lns) {
+            // Большие окрестности: по цепочке на поток, у каждой свой оператор разрушения
+            ThreadPool pool(num_threads);
+            LnsConfig config;
+            config.seconds = portfolio_seconds;
+            config.seed = std::chrono::system_clock::now().time_since_epoch().count();
+            LnsResult result = LargeNeighbourhoodSearch(pool, *coolingSchedule, initialTemperature, config)
+                                   .run(*global_best_solution);
+            print_lns_report(std::cout, result);
+            global_best_solution = result.best;
+            thread_iterations[0] = result.iterations;
+            if (polish) {
+                global_best_solution = global_best_solution->clone();
+                polish_solution(*global_best_solution);
+            }
+            globalNoImprovementCount = maxNoImprovement;
+        }
+
+        while (globalNoImprovementCount < maxNoImprovement && within_budget()) {
             std::vector<std::thread> threads;
             std::vector<std::shared_ptr<Solution>> local_best_solutions(num_threads);
 
@@ -41,10 +334,19 @@ int main(int argc, char *argv[]) {
                     initialSolution = global_best_solution->clone_new_seed(seed);
                     
 
-                    SimulatedAnnealing sa(initialSolution.get(), &mutationOperation, &coolingSchedule, initialTemperature, seed);
-                    sa.run();
+                    auto engine = make_search_engine(engine_name, initialSolution.get(), &mutationOperation,
+                                                     coolingSchedule.get(), initialTemperature, seed);
+                    PerfCounters counters;
+                    counters.start();
+                    engine->run();
+                    thread_perf[i] += counters.stop();
+                    thread_iterations[i] += engine->get_iterations();
 
-                    local_best_solutions[i] = sa.getLocalBestSolution();
+                    local_best_solutions[i] = engine->getLocalBestSolution();
+                    if (polish) {
+                        // Доводка локального спуска до сравнения с глобальным рекордом
+                        polish_solution(*local_best_solutions[i]);
+                    }
                 });
             }
 
@@ -67,7 +369,36 @@ int main(int argc, char *argv[]) {
 
             std::cout << "Current best solution cost: " << global_best_solution->get_cost() << std::endl;
         }
-        std::cout << "Current best solution cost: " << global_best_solution->get_cost() << std::endl;
+        std::cout << "Current best solution cost: "
+                  << (global_best_solution ? global_best_solution->get_cost() : assignment_best) << std::endl;
+
+        if (!export_file.empty()) {
+            export_schedule(dynamic_cast<SchedulingSolution &>(*global_best_solution), export_file,
+                            parse_schedule_format(export_format));
+            std::cout << "Расписание записано в " << export_file << std::endl;
+        }
+
+        if (cache) {
+            if (global_best_solution) {
+                auto &best = dynamic_cast<SchedulingSolution &>(*global_best_solution);
+                cache->store(fingerprint, ClassAssignment::from_assignment(job_durations, best.get_assignment(),
+                                                                           num_processors, best.get_cost()));
+            } else {
+                cache->store(fingerprint, ClassAssignment::from_assignment(job_durations, assignment, num_processors,
+                                                                           assignment_best));
+            }
+            cache->save();
+        }
+
+        PerfSample solve_perf;
+        long long solve_iterations = 0;
+        for (int i = 0; i < num_threads; ++i) {
+            print_perf_report(std::cout, "thread " + std::to_string(i), thread_perf[i],
+                              thread_iterations[i], num_jobs);
+            solve_perf += thread_perf[i];
+            solve_iterations += thread_iterations[i];
+        }
+        print_perf_report(std::cout, "solve", solve_perf, solve_iterations, num_jobs);
     } catch (const std::exception &e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
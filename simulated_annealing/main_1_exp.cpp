@@ -1,25 +1,43 @@
 #include "SimulatedAnnealing.h"
 #include "load_CSV.cpp"
+#include "PerfCounters.h"
+#include "Instances.h"
+#include "ResultStore.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <chrono>
 
-double measure_sequential_time(int num_jobs, int num_processors, TemperatureLaw* law, int seed) {
-    std::vector<uint8_t> job_times(num_jobs);
+// jobs.csv читается один раз; экземпляр нужного размера собирается в памяти
+std::vector<uint32_t> sequential_instance(int num_jobs) {
+    static const std::vector<uint32_t> base_jobs = load_jobs("jobs.csv");
+    return make_instance(base_jobs, num_jobs, DEFAULT_INSTANCE_SEED);
+}
 
-    job_times = load_jobs("jobs.csv");
+StoredResult measure_sequential(int num_jobs, int num_processors, TemperatureLaw* law, int seed) {
+    std::vector<uint32_t> job_times = sequential_instance(num_jobs);
     
-    auto initial_solution = std::make_shared<SchedulingSolution>(
+    auto initial_solution = make_scheduling_solution(
         num_jobs, num_processors, job_times, seed);
     SchedulingMutation mutation;
     
     auto start = std::chrono::high_resolution_clock::now();
     SimulatedAnnealing sa(initial_solution.get(), &mutation, law, 1000.0, seed);
+    PerfCounters counters;
+    counters.start();
     sa.run();
+    PerfSample perf = counters.stop();
     auto end = std::chrono::high_resolution_clock::now();
+    print_perf_report(std::cout, "jobs=" + std::to_string(num_jobs) + " processors=" +
+                      std::to_string(num_processors) + " seed=" + std::to_string(seed),
+                      perf, sa.get_iterations(), num_jobs);
     
-    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0; // в секундах
+    double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+    return {seconds, sa.getLocalBestSolution()->get_cost(), sa.get_iterations()};
+}
+
+double measure_sequential_time(int num_jobs, int num_processors, TemperatureLaw* law, int seed) {
+    return measure_sequential(num_jobs, num_processors, law, seed).time; // в секундах
 }
 
 std::vector<int> find_heavy_inputs() {
@@ -65,18 +83,25 @@ void compare_solution_quality(int heavy_jobs, int heavy_processors) {
     std::cout << "Jobs: " << heavy_jobs << ", Processors: " << heavy_processors << "\n";
     std::cout << "=================================================\n";
     
-    std::vector<uint8_t> job_times(heavy_jobs);
-    job_times = load_jobs("jobs.csv"); 
+    std::vector<uint32_t> job_times = sequential_instance(heavy_jobs);
     // Создаем законы охлаждения
     BoltzmannLaw boltzmann(1000.0);
     CauchyLaw cauchy(1000.0);
     LogarithmicCauchyLaw log_cauchy(1000.0);
+    AdaptiveLaw adaptive(1000.0);
+    {
+        // Калибровка начальной температуры адаптивного закона по пробным ходам
+        auto probe = make_scheduling_solution(heavy_jobs, heavy_processors, job_times, 42);
+        SchedulingMutation mutation;
+        calibrate_temperature(adaptive, *probe, mutation);
+    }
     
     // Массив для итерации
     CoolingLawInfo laws[] = {
         {&boltzmann, "Boltzmann"},
         {&cauchy, "Cauchy"},
-        {&log_cauchy, "Log-Cauchy"}
+        {&log_cauchy, "Log-Cauchy"},
+        {&adaptive, "Adaptive"}
     };
     
     const int num_runs = 5;
@@ -84,16 +109,22 @@ void compare_solution_quality(int heavy_jobs, int heavy_processors) {
     for (const auto& law_info : laws) {
         double total_cost = 0;
         double total_time = 0;
+        PerfSample total_perf;
+        long long total_iterations = 0;
         
         for (int run = 0; run < num_runs; ++run) {
-            auto initial_solution = std::make_shared<SchedulingSolution>(
+            auto initial_solution = make_scheduling_solution(
                 heavy_jobs, heavy_processors, job_times, 42 + run);
             SchedulingMutation mutation;
             
             auto start = std::chrono::high_resolution_clock::now();
             SimulatedAnnealing sa(initial_solution.get(), &mutation, law_info.law, 1000.0, 42 + run);
+            PerfCounters counters;
+            counters.start();
             sa.run();
+            total_perf += counters.stop();
             auto end = std::chrono::high_resolution_clock::now();
+            total_iterations += sa.get_iterations();
             
             total_cost += sa.getLocalBestSolution()->get_cost();
             total_time += std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -102,15 +133,21 @@ void compare_solution_quality(int heavy_jobs, int heavy_processors) {
         std::cout << law_info.name << " Law:\n";
         std::cout << "  Average Cost: " << total_cost / num_runs << "\n";
         std::cout << "  Average Time: " << total_time / num_runs / 1000.0 << "s\n";
+        std::cout << "  Cost x CPU-seconds: " << (total_cost / num_runs) * (total_time / num_runs / 1000.0) << "\n";
+        print_perf_report(std::cout, std::string(law_info.name) + ", all runs", total_perf,
+                          total_iterations, heavy_jobs * num_runs);
         std::cout << "----------------------------------------\n";
     }
 }
 
-// Построение тепловой карты
+// Построение тепловой карты. Измерения берутся из хранилища результатов, если ячейка с тем же
+// экземпляром, зерном и сборкой уже считалась; заново запускаются только недостающие
 void generate_heatmap_data() {
     const int num_runs = 5;
     
     BoltzmannLaw law(1000.0); // Используем один закон
+    ResultStore store;
+    int cached = 0;
     
     std::ofstream file("heatmap_data.csv");
     file << "Jobs,Processors,Time" << std::endl;
@@ -121,9 +158,19 @@ void generate_heatmap_data() {
     for (int jobs: jobs_list) {
         for (int processors: processors_list) {
             double total_time = 0;
+            uint64_t instance = instance_hash(sequential_instance(jobs), processors);
+            std::string config = "jobs=" + std::to_string(jobs) + ";processors=" + std::to_string(processors) +
+                                 ";law=boltzmann;temperature=1000";
             
             for (int run = 0; run < num_runs; ++run) {
-                total_time += measure_sequential_time(jobs, processors, &law, 42 + run);
+                std::optional<StoredResult> result = store.lookup("heatmap", instance, config, 42 + run);
+                if (result) {
+                    cached++;
+                } else {
+                    result = measure_sequential(jobs, processors, &law, 42 + run);
+                    store.append("heatmap", instance, config, 42 + run, *result);
+                }
+                total_time += result->time;
             }
             
             double avg_time = total_time / num_runs;
@@ -135,6 +182,7 @@ void generate_heatmap_data() {
     }
     
     file.close();
+    std::cout << "Из хранилища взято " << cached << " измерений (сборка " << store.build_id() << ")\n";
     std::cout << "Данные сохранены в heatmap_data.csv\n";
 }
 
@@ -1,5 +1,9 @@
 // parallel_research.cpp
 #include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "Racing.h"
+#include "ResultStore.h"
 #include "load_CSV.cpp"
 #include <iostream>
 #include <fstream>
@@ -7,6 +11,33 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
+
+// Режим измерения: фиксированная работа (одинаковое число итераций на раунд при любом
+// числе потоков), фиксированное качество (время до достижения целевой стоимости) или
+// гонка цепочек против равномерного распределения того же бюджета
+enum class ScalingMode { FixedWork, FixedQuality, Racing };
+
+struct ScalingConfig {
+    std::vector<int> thread_counts = {1, 2, 4, 8};
+    int repetitions = 10;
+    int warmup = 1;
+    unsigned int seed_base = 100;
+    ScalingMode mode = ScalingMode::FixedWork;
+    int rounds = 10;              // число раундов синхронизации (режим фиксированной работы)
+    int total_iterations = 1000;  // общий бюджет итераций на раунд, делится между потоками
+    double target_cost = -1;      // цель для режима качества; < 0 — калибруется по 1 потоку
+    int max_rounds = 200;         // ограничение, если цель недостижима
+};
+
+struct RunResult {
+    double time;
+    double cost;
+    int rounds;
+    bool reached;
+    long long iterations;
+    PerfSample perf;
+};
 
 class ParallelResearch {
 private:
@@ -15,41 +46,47 @@ private:
     
 public:
     // Запуск параллельного алгоритма с заданным количеством потоков
-    double run_parallel_experiment(int num_threads, int num_jobs, int num_processors, 
-                                  const std::vector<uint8_t>& job_times, int seed_base) {
+    RunResult run_parallel_experiment(const ScalingConfig &config, int num_threads, int num_jobs,
+                                      int num_processors, const std::vector<uint32_t>& job_times,
+                                      unsigned int seed_base) {
         global_best.reset();
         
-        auto start = std::chrono::high_resolution_clock::now();
+        auto start = std::chrono::steady_clock::now();
         
         // Создание начального решения
         if (!global_best) {
-            global_best = std::make_shared<SchedulingSolution>(
-                num_jobs, num_processors, const_cast<std::vector<uint8_t>&>(job_times), seed_base);
+            global_best = make_scheduling_solution(num_jobs, num_processors, job_times, seed_base);
         }
         
-        // ИСПРАВЛЕНИЕ: Уменьшаем общее количество итераций при параллельной работе
-        int total_iterations = 1000;  // Общий бюджет итераций
-        int iterations_per_thread = std::max(100, total_iterations / num_threads);
-        
-        int global_no_improvement = 0;
-        const int max_no_improvement = 10;
+        // Общий бюджет раунда делится между потоками, так что работа не зависит от их числа
+        int iterations_per_thread = (config.total_iterations + num_threads - 1) / num_threads;
         
         BoltzmannLaw cooling(1000.0);
         SchedulingMutation mutation;
         
-        while (global_no_improvement < max_no_improvement) {
+        PerfAccumulator perf;
+        std::atomic<long long> iterations{0};
+        int round = 0;
+        while (true) {
+            if (config.mode == ScalingMode::FixedWork && round >= config.rounds) break;
+            if (config.mode == ScalingMode::FixedQuality &&
+                (global_best->get_cost() <= config.target_cost || round >= config.max_rounds)) break;
+
             std::vector<std::thread> threads;
             std::vector<std::shared_ptr<Solution>> local_bests(num_threads);
             
             for (int i = 0; i < num_threads; ++i) {
                 threads.emplace_back([&, i, iterations_per_thread]() {
-                    unsigned int seed = seed_base + i + std::chrono::system_clock::now().time_since_epoch().count();
+                    unsigned int seed = derive_seed(seed_base, round, i);
                     auto initial_solution = global_best->clone_new_seed(seed);
                     
-                    // ИСПРАВЛЕНИЕ: Каждый поток делает меньше итераций
                     SimulatedAnnealingLimited sa(initial_solution.get(), &mutation, &cooling, 
                                                  1000.0, seed, iterations_per_thread);
+                    PerfCounters counters;
+                    counters.start();
                     sa.run();
+                    perf.add(counters.stop());
+                    iterations += iterations_per_thread;
                     
                     local_bests[i] = sa.getLocalBestSolution();
                 });
@@ -59,24 +96,20 @@ public:
                 t.join();
             }
             
-            bool improved = false;
             for (const auto &local_best : local_bests) {
                 if (local_best->get_cost() < global_best->get_cost()) {
                     std::lock_guard<std::mutex> lock(best_solution_mutex);
                     global_best = local_best;
-                    improved = true;
                 }
             }
-            
-            if (improved) {
-                global_no_improvement = 0;
-            } else {
-                global_no_improvement++;
-            }
+            round++;
         }
         
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+        auto end = std::chrono::steady_clock::now();
+        double cost = global_best->get_cost();
+        return {std::chrono::duration<double>(end - start).count(), cost, round,
+                config.mode == ScalingMode::FixedWork || cost <= config.target_cost,
+                iterations.load(), perf.get()};
     }
     
     std::shared_ptr<Solution> get_best_solution() const {
@@ -84,7 +117,7 @@ public:
     }
 
 private:
-    // НОВЫЙ КЛАСС: SimulatedAnnealing с ограничением итераций
+    // SimulatedAnnealing с фиксированным числом итераций
     class SimulatedAnnealingLimited {
     private:
         std::shared_ptr<Solution> solution;
@@ -94,6 +127,7 @@ private:
         double initial_temp;
         double temperature;
         std::mt19937 rng;
+        std::uniform_real_distribution<double> unit{0.0, 1.0};
         int max_iterations;
     
     public:
@@ -114,12 +148,11 @@ private:
 
         void run() {
             int iter = 0;
-            int iter_no_impr = 0;
             double best_cost = solution->get_cost();
             best_solution = solution->clone();
             temperature = initial_temp;
 
-            while (iter_no_impr < max_iterations && iter < max_iterations * 2) {
+            while (iter < max_iterations) {
                 auto new_solution = best_solution->clone();
                 mutation->apply(*new_solution);
 
@@ -128,17 +161,12 @@ private:
                 if (new_cost < best_cost) {
                     best_solution = new_solution;
                     best_cost = new_cost;
-                    iter_no_impr = 0;
                 }
                 else {
                     double acceptanceProbability = std::exp(-(new_cost - best_cost) / temperature);
-                    if (acceptanceProbability >= static_cast<double>(rand()) / RAND_MAX) {
-                        iter_no_impr = 0;
+                    if (acceptanceProbability >= unit(rng)) {
                         best_solution = new_solution;
                     } 
-                    else {
-                        iter_no_impr++;
-                    }
                 }
                 temperature = temp_law->get_next_temperature(iter);
                 iter++;
@@ -151,71 +179,233 @@ private:
     };
 };
 
+struct ScalingPoint {
+    int threads;
+    std::vector<double> times;
+    std::vector<double> costs;
+    int reached = 0;
+    long long iterations = 0;
+    PerfSample perf;
+    SampleStats time_stats;
+    SampleStats cost_stats;
+    SampleStats speedup_stats;
+};
+
+void write_scaling_json(const std::string &filename, const ScalingConfig &config,
+                        int num_jobs, int num_processors, const std::vector<ScalingPoint> &points) {
+    std::ofstream json(filename);
+    json << "{\n";
+    json << "  \"mode\": \"" << (config.mode == ScalingMode::FixedWork ? "fixed-work" : "fixed-quality") << "\",\n";
+    json << "  \"jobs\": " << num_jobs << ",\n";
+    json << "  \"processors\": " << num_processors << ",\n";
+    json << "  \"repetitions\": " << config.repetitions << ",\n";
+    json << "  \"warmup\": " << config.warmup << ",\n";
+    json << "  \"seed_base\": " << config.seed_base << ",\n";
+    json << "  \"rounds\": " << config.rounds << ",\n";
+    json << "  \"total_iterations\": " << config.total_iterations << ",\n";
+    json << "  \"target_cost\": " << config.target_cost << ",\n";
+    json << "  \"results\": [\n";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto &p = points[i];
+        json << "    {\"threads\": " << p.threads
+             << ", \"reached\": " << p.reached
+             << ",\n     \"time\": " << to_json(p.time_stats)
+             << ",\n     \"cost\": " << to_json(p.cost_stats)
+             << ",\n     \"speedup\": " << to_json(p.speedup_stats)
+             << ",\n     \"time_samples\": " << to_json(p.times)
+             << ",\n     \"cost_samples\": " << to_json(p.costs) << "}"
+             << (i + 1 < points.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+}
+
+// Конфигурация прогона для ключа хранилища: все, от чего зависит результат, кроме зерна
+std::string scaling_config_key(const ScalingConfig &config, int threads, int num_jobs, int num_processors) {
+    std::ostringstream key;
+    key << "mode=" << (config.mode == ScalingMode::FixedWork ? "work" : "quality") << ";threads=" << threads
+        << ";jobs=" << num_jobs << ";processors=" << num_processors << ";rounds=" << config.rounds
+        << ";iters=" << config.total_iterations;
+    if (config.mode == ScalingMode::FixedQuality) {
+        key << ";target=" << config.target_cost << ";max_rounds=" << config.max_rounds;
+    }
+    return key.str();
+}
+
+// Прогон из хранилища, если он уже измерялся этой сборкой, иначе заново с записью в хранилище.
+// Счетчики производительности есть только у новых прогонов.
+RunResult stored_parallel_experiment(ResultStore &store, ParallelResearch &research, const ScalingConfig &config,
+                                     int threads, int num_jobs, int num_processors,
+                                     const std::vector<uint32_t> &job_times, uint64_t instance, unsigned int seed) {
+    std::string key = scaling_config_key(config, threads, num_jobs, num_processors);
+    if (auto stored = store.lookup("parallel_scaling", instance, key, seed)) {
+        bool reached = config.mode == ScalingMode::FixedWork || stored->cost <= config.target_cost;
+        return {stored->time, stored->cost, 0, reached, stored->iterations, PerfSample()};
+    }
+    RunResult result = research.run_parallel_experiment(config, threads, num_jobs, num_processors, job_times, seed);
+    store.append("parallel_scaling", instance, key, seed, {result.time, result.cost, result.iterations});
+    return result;
+}
+
 // Исследование масштабируемости параллельного алгоритма
-void parallel_scaling_study() {
+void parallel_scaling_study(ScalingConfig config) {
     const int num_jobs = 12800;
     const int num_processors = 20;
-    const int num_runs = 2;
     
     // Генерация тестовых данных
-    std::vector<uint8_t> job_times = load_jobs("jobs.csv");
+    std::vector<uint32_t> job_times = load_jobs("jobs.csv");
     
-    std::vector<int> thread_counts = {1, 2, 4, 8};
     ParallelResearch research;
-    
-    std::ofstream file("parallel_scaling.csv");
-    file << "Threads,Time,Cost,Speedup,Efficiency" << std::endl;
+    ResultStore store;
+    uint64_t instance = instance_hash(job_times, num_processors);
     
     std::cout << "Исследование масштабируемости параллельного алгоритма:\n";
     std::cout << "Jobs: " << num_jobs << ", Processors: " << num_processors << "\n";
+    std::cout << "Mode: " << (config.mode == ScalingMode::FixedWork ? "fixed-work" : "fixed-quality")
+              << ", Repetitions: " << config.repetitions << ", Warmup: " << config.warmup << "\n";
+
+    // Цель по умолчанию — медианная стоимость однопоточного прогона с фиксированной работой
+    if (config.mode == ScalingMode::FixedQuality && config.target_cost < 0) {
+        ScalingConfig calibration = config;
+        calibration.mode = ScalingMode::FixedWork;
+        std::vector<double> costs;
+        for (int run = 0; run < config.repetitions; ++run) {
+            costs.push_back(stored_parallel_experiment(store, research, calibration, 1, num_jobs, num_processors,
+                                                       job_times, instance, config.seed_base + run).cost);
+        }
+        config.target_cost = median_of(costs);
+        std::cout << "Calibrated target cost: " << config.target_cost << "\n";
+    }
     std::cout << "=================================================\n";
     
-    double sequential_time = 0;
-    
-    for (int threads : thread_counts) {
-        double total_time = 0;
-        double total_cost = 0;
-        
-        for (int run = 0; run < num_runs; ++run) {
-            double time = research.run_parallel_experiment(threads, num_jobs, num_processors, job_times, 100 + run);
-            double cost = research.get_best_solution()->get_cost();
-            
-            total_time += time;
-            total_cost += cost;
+    std::vector<ScalingPoint> points;
+    for (int threads : config.thread_counts) {
+        ScalingPoint point;
+        point.threads = threads;
+
+        // Прогрев нужен, только если хоть один повтор придется запускать
+        std::string key = scaling_config_key(config, threads, num_jobs, num_processors);
+        bool all_stored = true;
+        for (int run = 0; run < config.repetitions; ++run) {
+            all_stored &= store.lookup("parallel_scaling", instance, key, config.seed_base + run).has_value();
         }
-        
-        double avg_time = total_time / num_runs;
-        double avg_cost = total_cost / num_runs;
-        
-        if (threads == 1) {
-            sequential_time = avg_time;
+        for (int run = 0; run < config.warmup && !all_stored; ++run) {
+            research.run_parallel_experiment(config, threads, num_jobs, num_processors, job_times,
+                                             config.seed_base + config.repetitions + run);
         }
+        // Один и тот же набор зерен для каждого числа потоков
+        for (int run = 0; run < config.repetitions; ++run) {
+            RunResult result = stored_parallel_experiment(store, research, config, threads, num_jobs, num_processors,
+                                                          job_times, instance, config.seed_base + run);
+            point.times.push_back(result.time);
+            point.costs.push_back(result.cost);
+            point.reached += result.reached;
+            point.iterations += result.iterations;
+            point.perf += result.perf;
+        }
+        point.time_stats = summarize(point.times);
+        point.cost_stats = summarize(point.costs);
+        points.push_back(point);
+    }
+
+    // База для ускорения — наименьшее число потоков (обычно 1)
+    const ScalingPoint &baseline = points.front();
+    std::ofstream file("parallel_scaling.csv");
+    file << "Threads,Time,Cost,Speedup,Efficiency,Time_Low,Time_High,Cost_Low,Cost_High,"
+         << "Speedup_Low,Speedup_High,Reached" << std::endl;
+
+    for (auto &point : points) {
+        point.speedup_stats = summarize_ratio(baseline.times, point.times);
+        double speedup = point.speedup_stats.median;
+        double efficiency = speedup * baseline.threads / point.threads;
         
-        double speedup = sequential_time / avg_time;
-        double efficiency = speedup / threads;
-        
-        file << threads << "," << avg_time << "," << avg_cost << "," 
-             << speedup << "," << efficiency << std::endl;
+        file << point.threads << "," << point.time_stats.median << "," << point.cost_stats.median << ","
+             << speedup << "," << efficiency << ","
+             << point.time_stats.ci_low << "," << point.time_stats.ci_high << ","
+             << point.cost_stats.ci_low << "," << point.cost_stats.ci_high << ","
+             << point.speedup_stats.ci_low << "," << point.speedup_stats.ci_high << ","
+             << point.reached << std::endl;
         
-        std::cout << "Threads: " << threads << "\n";
-        std::cout << "  Avg Time: " << avg_time << "s\n";
-        std::cout << "  Avg Cost: " << avg_cost << "\n";
-        std::cout << "  Speedup: " << speedup << "x\n";
+        std::cout << "Threads: " << point.threads << "\n";
+        std::cout << "  Median Time: " << point.time_stats.median << "s  [" 
+                  << point.time_stats.ci_low << ", " << point.time_stats.ci_high << "]\n";
+        std::cout << "  Median Cost: " << point.cost_stats.median << "  [" 
+                  << point.cost_stats.ci_low << ", " << point.cost_stats.ci_high << "]\n";
+        std::cout << "  Speedup: " << speedup << "x  [" 
+                  << point.speedup_stats.ci_low << ", " << point.speedup_stats.ci_high << "]\n";
         std::cout << "  Efficiency: " << efficiency * 100 << "%\n";
+        if (config.mode == ScalingMode::FixedQuality) {
+            std::cout << "  Reached target: " << point.reached << "/" << config.repetitions << "\n";
+        }
         
-        if (threads > 1) {
-            double improvement = (sequential_time - avg_time) / sequential_time * 100;
-            std::cout << "  Improvement: " << improvement << "%\n";
-            
-            if (improvement < 10) {
-                std::cout << "  WARNING: Improvement less than 10%\n";
-            }
+        if (point.threads > baseline.threads && point.speedup_stats.ci_low <= 1.0) {
+            std::cout << "  WARNING: speedup is not significant at 95%\n";
         }
+        print_perf_report(std::cout, std::to_string(point.threads) + " threads, all repetitions",
+                          point.perf, point.iterations, num_jobs);
         std::cout << "----------------------------------------\n";
     }
     
     file.close();
-    std::cout << "Данные сохранены в parallel_scaling.csv\n";
+    write_scaling_json("parallel_scaling.json", config, num_jobs, num_processors, points);
+    std::cout << "Данные сохранены в parallel_scaling.csv и parallel_scaling.json\n";
+}
+
+// Гонка (successive halving) против равномерного распределения при одинаковом бюджете
+// итераций: rounds * iters на весь прогон. Равномерный вариант — по цепочке на поток.
+void racing_study(const ScalingConfig &config) {
+    const int num_jobs = 12800;
+    const int num_processors = 20;
+    std::vector<uint32_t> job_times = load_jobs("jobs.csv");
+    long long budget = static_cast<long long>(config.rounds) * config.total_iterations;
+
+    std::cout << "Гонка цепочек против равномерного распределения:\n";
+    std::cout << "Jobs: " << num_jobs << ", Processors: " << num_processors
+              << ", Budget: " << budget << " iterations, Repetitions: " << config.repetitions << "\n";
+    std::cout << "=================================================\n";
+
+    BoltzmannLaw cooling(1000.0);
+    SchedulingMutation mutation;
+    std::ofstream file("race_vs_uniform.csv");
+    file << "Threads,Uniform_Cost,Uniform_Low,Uniform_High,Race_Cost,Race_Low,Race_High,"
+         << "Uniform_Time,Race_Time" << std::endl;
+
+    for (int threads : config.thread_counts) {
+        ThreadPool pool(threads);
+        std::vector<double> uniform_costs, race_costs, uniform_times, race_times;
+        for (int run = 0; run < config.warmup + config.repetitions; ++run) {
+            unsigned int seed = config.seed_base + run;
+            auto initial = make_scheduling_solution(num_jobs, num_processors, job_times, seed);
+
+            RacingConfig uniform = {threads, 1, budget, seed};
+            RacingConfig racing = {4 * threads, 2, budget, seed};
+            auto start = std::chrono::steady_clock::now();
+            RaceResult uniform_result = AnnealingRace(pool, mutation, cooling, 1000.0, uniform).run(*initial);
+            auto middle = std::chrono::steady_clock::now();
+            RaceResult race_result = AnnealingRace(pool, mutation, cooling, 1000.0, racing).run(*initial);
+            auto end = std::chrono::steady_clock::now();
+            if (run < config.warmup) continue;
+
+            uniform_costs.push_back(uniform_result.best->get_cost());
+            race_costs.push_back(race_result.best->get_cost());
+            uniform_times.push_back(std::chrono::duration<double>(middle - start).count());
+            race_times.push_back(std::chrono::duration<double>(end - middle).count());
+        }
+        SampleStats uniform_stats = summarize(uniform_costs);
+        SampleStats race_stats = summarize(race_costs);
+        double uniform_time = median_of(uniform_times);
+        double race_time = median_of(race_times);
+
+        file << threads << "," << uniform_stats.median << "," << uniform_stats.ci_low << "," << uniform_stats.ci_high
+             << "," << race_stats.median << "," << race_stats.ci_low << "," << race_stats.ci_high
+             << "," << uniform_time << "," << race_time << std::endl;
+        std::cout << "Threads: " << threads << "\n";
+        std::cout << "  Uniform: cost " << uniform_stats.median << "  [" << uniform_stats.ci_low << ", "
+                  << uniform_stats.ci_high << "], time " << uniform_time << "s\n";
+        std::cout << "  Race:    cost " << race_stats.median << "  [" << race_stats.ci_low << ", "
+                  << race_stats.ci_high << "], time " << race_time << "s\n";
+        std::cout << "----------------------------------------\n";
+    }
+    std::cout << "Данные сохранены в race_vs_uniform.csv\n";
 }
 
 // Определение оптимального количества потоков
@@ -268,9 +458,72 @@ void find_optimal_threads() {
     file.close();
 }
 
-int main() {
-    parallel_scaling_study();
-    find_optimal_threads();
-    
+// Список положительных чисел через запятую: 0 потоков делит бюджет на ноль, пустой список
+// оставляет исследование без базовой точки
+std::vector<int> parse_int_list(const std::string &name, const std::string &text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        values.push_back(std::stoi(item));
+        if (values.back() < 1) throw std::runtime_error(name + " values must be positive, got " + item);
+    }
+    if (values.empty()) throw std::runtime_error(name + " must list at least one value");
+    return values;
+}
+
+int parse_positive(const std::string &name, const std::string &text) {
+    int value = std::stoi(text);
+    if (value < 1) throw std::runtime_error(name + " must be positive, got " + text);
+    return value;
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        ScalingConfig config;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--reps") config.repetitions = parse_positive(arg, value);
+            else if (arg == "--warmup") config.warmup = std::stoi(value);
+            else if (arg == "--seed") config.seed_base = std::stoul(value);
+            else if (arg == "--rounds") config.rounds = std::stoi(value);
+            else if (arg == "--iters") config.total_iterations = std::stoi(value);
+            else if (arg == "--target") config.target_cost = std::stod(value);
+            else if (arg == "--max-rounds") config.max_rounds = std::stoi(value);
+            else if (arg == "--threads") config.thread_counts = parse_int_list(arg, value);
+            else if (arg == "--mode") {
+                if (value == "work") config.mode = ScalingMode::FixedWork;
+                else if (value == "quality") config.mode = ScalingMode::FixedQuality;
+                else if (value == "race") config.mode = ScalingMode::Racing;
+                else {
+                    std::cerr << "Unknown mode " << value << " (expected work|quality|race)" << std::endl;
+                    return 1;
+                }
+            }
+            else {
+                std::cerr << "Usage: " << argv[0] << " [--mode work|quality|race] [--reps N] [--warmup N]"
+                          << " [--seed S] [--rounds R] [--iters I] [--target C] [--max-rounds R]"
+                          << " [--threads 1,2,4,8]" << std::endl;
+                return 1;
+            }
+        }
+
+        if (config.mode == ScalingMode::Racing) {
+            racing_study(config);
+            return 0;
+        }
+        parallel_scaling_study(config);
+        find_optimal_threads();
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,85 @@
+#include "OnlineScheduler.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+// Онлайн-планировщик: работы читаются из потока (stdin или --input) по одной в строке —
+// "id,duration", как в jobs.csv, или просто "duration"; нечисловая первая строка считается
+// заголовком. На каждую работу сразу печатается "assign,id,processor", на каждый перенос
+// фоновой балансировки — "move,id,processor".
+//   ./online [--processors 40] [--window 4096] [--interval 50] [--iterations 20000]
+//            [--temperature 10] [--law boltzmann] [--input file]
+
+int main(int argc, char *argv[]) {
+    try {
+        OnlineConfig config;
+        std::string input;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            std::string value = argv[i + 1];
+            if (arg == "--processors") config.num_processors = std::stoi(value);
+            else if (arg == "--window") config.window = std::stoul(value);
+            else if (arg == "--interval") config.interval_ms = std::stoi(value);
+            else if (arg == "--iterations") config.pass_iterations = std::stoll(value);
+            else if (arg == "--temperature") config.temperature = std::stod(value);
+            else if (arg == "--law") config.law = value;
+            else if (arg == "--input") input = value;
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+
+        std::ifstream file;
+        if (!input.empty()) {
+            file.open(input);
+            if (!file.is_open()) throw std::runtime_error("Unable to open file " + input);
+        }
+        std::istream &in = input.empty() ? std::cin : file;
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+
+        std::mutex out_mutex;
+        OnlineScheduler scheduler(config, [&](const char *kind, const std::string &id, int processor) {
+            std::lock_guard<std::mutex> lock(out_mutex);
+            std::cout << kind << ',' << id << ',' << processor << '\n';
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        std::string line;
+        uint64_t line_number = 0;
+        while (std::getline(in, line)) {
+            line_number++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            size_t comma = line.find(',');
+            std::string id = comma == std::string::npos ? std::to_string(line_number) : line.substr(0, comma);
+            std::string duration = comma == std::string::npos ? line : line.substr(comma + 1);
+            long long value;
+            try {
+                value = std::stoll(duration);
+            } catch (const std::invalid_argument &) {
+                if (line_number == 1) continue;  // заголовок
+                throw std::runtime_error("Line " + std::to_string(line_number) + ": bad duration " + duration);
+            }
+            if (value < 0 || value > UINT32_MAX) {
+                throw std::runtime_error("Duration " + duration + " of job " + id + " does not fit into 32 bits");
+            }
+            scheduler.submit(id, static_cast<uint32_t>(value));
+            // Вывод сбрасывается, когда входных данных в буфере не осталось и чтение может заблокироваться
+            if (in.rdbuf()->in_avail() <= 0) {
+                std::lock_guard<std::mutex> lock(out_mutex);
+                std::cout.flush();
+            }
+        }
+        scheduler.finish();
+        std::cout.flush();
+
+        OnlineStats stats = scheduler.get_stats();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Jobs: " << stats.jobs << ", K1: " << scheduler.get_cost() << ", moves: " << stats.moves
+                  << ", passes: " << stats.passes << " (" << stats.rejected_passes << " rejected), "
+                  << seconds << "s" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -2,10 +2,38 @@ import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import numpy as np
+import os
+
+RESULT_STORE = 'experiment_store.csv'
+
+def to_numeric_if_possible(column):
+    try:
+        return pd.to_numeric(column)
+    except (ValueError, TypeError):
+        return column
+
+def load_store(experiment):
+    """Измерения эксперимента из хранилища результатов (ResultStore.h), только последняя сборка;
+    строка Config разворачивается в столбцы"""
+    if not os.path.exists(RESULT_STORE):
+        return pd.DataFrame()
+    data = pd.read_csv(RESULT_STORE, on_bad_lines='skip')
+    data = data[data['Experiment'] == experiment]
+    if data.empty:
+        return data
+    data = data[data['Build'] == data['Build'].iloc[-1]]
+    config = data['Config'].str.split(';').apply(lambda items: dict(item.split('=', 1) for item in items))
+    config = pd.DataFrame(config.tolist(), index=data.index).apply(to_numeric_if_possible)
+    return data.join(config)
 
 def plot_heatmap():
     """Построение тепловой карты для последовательного алгоритма"""
-    data = pd.read_csv('heatmap_data.csv')
+    stored = load_store('heatmap')
+    if stored.empty:
+        data = pd.read_csv('heatmap_data.csv')
+    else:
+        data = stored.groupby(['jobs', 'processors'], as_index=False)['Time'].median()
+        data = data.rename(columns={'jobs': 'Jobs', 'processors': 'Processors'})
     pivot_table = data.pivot(index='Jobs', columns='Processors', values='Time')
     
     plt.figure(figsize=(12, 8))
@@ -16,15 +44,31 @@ def plot_heatmap():
     plt.savefig('heat_map.png', dpi=300, bbox_inches='tight')
     plt.show()
 
+def scaling_from_store(stored):
+    """Медианы по числу потоков для той же конфигурации, что у последнего прогона"""
+    keys = [column for column in ('mode', 'jobs', 'processors', 'rounds', 'iters', 'target', 'max_rounds')
+            if column in stored]
+    last = stored.iloc[-1]
+    same = (stored[keys].fillna(-1) == last[keys].fillna(-1)).all(axis=1)
+    data = stored[same].groupby('threads', as_index=False)[['Time', 'Cost']].median()
+    data = data.rename(columns={'threads': 'Threads'})
+    base = data.iloc[0]
+    data['Speedup'] = base['Time'] / data['Time']
+    data['Efficiency'] = data['Speedup'] * base['Threads'] / data['Threads']
+    return data
+
 def plot_parallel_scaling():
     """Построение графиков для параллельного алгоритма"""
-    data = pd.read_csv('parallel_scaling.csv')
+    stored = load_store('parallel_scaling')
+    data = pd.read_csv('parallel_scaling.csv') if stored.empty else scaling_from_store(stored)
     
     # График времени выполнения
     plt.figure(figsize=(10, 6))
     plt.plot(data['Threads'], data['Time'], 'bo-', linewidth=2, markersize=8)
+    if 'Time_Low' in data:
+        plt.fill_between(data['Threads'], data['Time_Low'], data['Time_High'], color='b', alpha=0.15, label='95% CI')
     plt.xlabel('Number of Threads (Nproc)')
-    plt.ylabel('Average Execution Time (seconds)')
+    plt.ylabel('Median Execution Time (seconds)')
     plt.title('Parallel Algorithm - Execution Time vs Number of Threads')
     plt.grid(True, alpha=0.3)
     plt.savefig('parallel_time.png', dpi=300, bbox_inches='tight')
@@ -33,6 +77,8 @@ def plot_parallel_scaling():
     # График ускорения
     plt.figure(figsize=(10, 6))
     plt.plot(data['Threads'], data['Speedup'], 'go-', linewidth=2, markersize=8, label='Actual Speedup')
+    if 'Speedup_Low' in data:
+        plt.fill_between(data['Threads'], data['Speedup_Low'], data['Speedup_High'], color='g', alpha=0.15, label='95% CI')
     plt.plot(data['Threads'], data['Threads'], 'r--', linewidth=1, label='Ideal Speedup')
     plt.xlabel('Number of Threads (Nproc)')
     plt.ylabel('Speedup')
@@ -52,6 +98,39 @@ def plot_parallel_scaling():
     plt.savefig('parallel_efficiency.png', dpi=300, bbox_inches='tight')
     plt.show()
 
+def plot_time_to_target():
+    """Эмпирические распределения времени до цели и профиль производительности (ttt_benchmark)"""
+    data = pd.read_csv('ttt_distribution.csv')
+    targets = sorted(data['Target'].unique(), reverse=True)
+    fig, axes = plt.subplots(1, len(targets), figsize=(5 * len(targets), 5), sharey=True, squeeze=False)
+    for ax, target in zip(axes[0], targets):
+        subset = data[data['Target'] == target]
+        for config, group in subset.groupby('Config'):
+            ax.step(group['Time'], group['Probability'], where='post', label=config)
+        ax.set_xscale('log')
+        ax.set_title(f'Target cost {target:g}')
+        ax.set_xlabel('Time to target (seconds)')
+        ax.grid(True, alpha=0.3)
+    axes[0][0].set_ylabel('Cumulative probability')
+    axes[0][-1].legend(fontsize=8)
+    plt.savefig('time_to_target.png', dpi=300, bbox_inches='tight')
+    plt.show()
+
+    profile = pd.read_csv('performance_profile.csv')
+    plt.figure(figsize=(10, 6))
+    for config, group in profile.groupby('Config'):
+        plt.step(group['Tau'], group['Fraction'], where='post', label=config)
+    plt.xscale('log')
+    plt.xlabel('Time ratio to the fastest configuration (tau)')
+    plt.ylabel('Fraction of (target, run) problems')
+    plt.title('Performance Profile')
+    plt.legend(fontsize=8)
+    plt.grid(True, alpha=0.3)
+    plt.savefig('performance_profile.png', dpi=300, bbox_inches='tight')
+    plt.show()
+
 if __name__ == "__main__":
     plot_heatmap()
     plot_parallel_scaling()
+    if os.path.exists('ttt_distribution.csv'):
+        plot_time_to_target()
@@ -0,0 +1,38 @@
+#include "Portfolio.h"
+#include <iostream>
+
+// Проверка выбора рук портфеля на синтетических бернуллиевских руках: одна рука
+// явно сильнее остальных и должна получить большую часть вытягиваний.
+//   ./portfolio_check [pulls] [seeds]
+
+int main(int argc, char *argv[]) {
+    int pulls = argc > 1 ? std::stoi(argv[1]) : 2000;
+    int seeds = argc > 2 ? std::stoi(argv[2]) : 20;
+    const std::vector<double> win_rates = {0.05, 0.05, 0.05, 0.05, 0.05, 0.3, 0.05, 0.05, 0.05, 0.05, 0.05, 0.05};
+    const int dominant = 5;
+    const double required_share = 0.6;
+
+    int failed = 0;
+    double share_sum = 0;
+    for (int seed = 1; seed <= seeds; ++seed) {
+        ThompsonBandit bandit(win_rates.size(), seed);
+        std::mt19937 rng(1000 + seed);
+        std::bernoulli_distribution coin;
+        int dominant_pulls = 0;
+        for (int pull = 0; pull < pulls; ++pull) {
+            int arm = bandit.select();
+            bool success = coin(rng, std::bernoulli_distribution::param_type(win_rates[arm]));
+            bandit.update(arm, success);
+            dominant_pulls += arm == dominant;
+        }
+        double share = static_cast<double>(dominant_pulls) / pulls;
+        share_sum += share;
+        if (share < required_share) {
+            std::cout << "seed " << seed << ": dominant arm got only " << share << " of pulls" << std::endl;
+            failed++;
+        }
+    }
+    std::cout << "Dominant arm share: mean " << share_sum / seeds << " over " << seeds << " seeds, "
+              << failed << " below " << required_share << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+#include "SimulatedAnnealing.h"
+#include "Benchmark.h"
+#include "Instances.h"
+#include "load_CSV.cpp"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// Время до цели (time-to-target): для каждой конфигурации (закон охлаждения, число потоков,
+// мутация) и каждого из серии порогов стоимости фиксируется момент, когда рекорд впервые
+// опустился до порога. По многим запускам с разными зернами получаются эмпирические
+// распределения времени до цели и профили производительности (Dolan–Moré): по ним и
+// выбирается конфигурация под ограничение на задержку.
+//   ./ttt_benchmark [--laws boltzmann,adaptive] [--threads 1,2] [--mutations move,balance]
+//                   [--runs 20] [--targets 200,100,50,20,10,5] [--jobs N] [--processors 40]
+//                   [--timeout 30] [--seed 1] [--stagnation 90]
+
+struct TttConfig {
+    std::vector<std::string> laws = {"boltzmann", "adaptive"};
+    std::vector<int> threads = {1, 2};
+    std::vector<std::string> mutations = {"move", "balance"};
+    int runs = 20;
+    std::vector<double> targets = {200, 100, 50, 20, 10, 5};
+    int jobs = 0;  // 0 — весь jobs.csv
+    int processors = 40;
+    double timeout = 30.0;           // секунд на запуск
+    double temperature = 100.0;
+    int max_no_improvement = 10;     // раундов без улучшения до остановки
+    int stagnation = DEFAULT_STAGNATION_LIMIT;  // ходов без рекорда до подогрева адаптивного закона
+    unsigned int seed = 1;
+};
+
+constexpr long long SLICE_ITERATIONS = 1000;
+
+struct SolverSetup {
+    std::string law;
+    int threads;
+    std::string mutation;
+
+    std::string name() const { return law + "/" + std::to_string(threads) + "t/" + mutation; }
+};
+
+struct TttRun {
+    std::vector<double> times;  // по порогам; INFINITY — порог не достигнут
+    double final_cost = 0;
+    double total_time = 0;
+};
+
+std::vector<std::string> split_list(const std::string &text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Один запуск: раунды по threads цепочек от общего рекорда, как в main.cpp. Цепочки сообщают
+// о каждом снижении стоимости, и первое время прохождения порога записывается сразу,
+// а не по окончании раунда.
+TttRun run_once(const TttConfig &config, const SolverSetup &setup, const std::vector<uint32_t> &jobs,
+                unsigned int seed) {
+    std::shared_ptr<Mutation> mutation = make_mutation(setup.mutation);
+    std::shared_ptr<TemperatureLaw> law = make_temperature_law(setup.law, config.temperature, config.stagnation);
+    std::shared_ptr<Solution> best = make_scheduling_solution(jobs.size(), config.processors, jobs, seed);
+    double temperature = config.temperature;
+    if (auto adaptive = std::dynamic_pointer_cast<AdaptiveLaw>(law)) {
+        temperature = calibrate_temperature(*adaptive, *best, *mutation, 100, seed);
+    }
+
+    TttRun run;
+    run.times.assign(config.targets.size(), INFINITY);
+    std::mutex mutex;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    size_t reached = 0;
+    auto record = [&](long long, double cost) {
+        std::lock_guard<std::mutex> lock(mutex);
+        double now = elapsed();
+        for (size_t t = 0; t < config.targets.size(); ++t) {
+            if (cost <= config.targets[t] && std::isinf(run.times[t])) {
+                run.times[t] = now;
+                reached++;
+            }
+        }
+    };
+    record(0, best->get_cost());
+
+    int no_improvement = 0;
+    for (int round = 0; no_improvement < config.max_no_improvement && reached < config.targets.size() &&
+                        elapsed() < config.timeout; ++round) {
+        std::vector<std::shared_ptr<Solution>> local(setup.threads);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < setup.threads; ++i) {
+            workers.emplace_back([&, i]() {
+                SimulatedAnnealing sa(best.get(), mutation.get(), law.get(), temperature, derive_seed(seed, round, i));
+                sa.set_progress_callback(record);
+                // Цепочка при высокой температуре может идти сколь угодно долго: порциями до таймаута
+                sa.start();
+                while (!sa.finished() && elapsed() < config.timeout) sa.advance(SLICE_ITERATIONS);
+                local[i] = sa.getLocalBestSolution();
+            });
+        }
+        for (auto &worker : workers) worker.join();
+
+        bool improved = false;
+        for (const auto &candidate : local) {
+            if (candidate->get_cost() < best->get_cost()) {
+                best = candidate;
+                improved = true;
+            }
+        }
+        no_improvement = improved ? 0 : no_improvement + 1;
+    }
+    run.final_cost = best->get_cost();
+    run.total_time = elapsed();
+    return run;
+}
+
+// q-квантиль времени до цели по всем запускам; INFINITY, если успешных запусков меньше доли q
+double time_quantile(std::vector<double> times, double q) {
+    if (times.empty()) return INFINITY;
+    std::sort(times.begin(), times.end());
+    size_t index = static_cast<size_t>(std::ceil(q * times.size())) - 1;
+    return times[std::min(index, times.size() - 1)];
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        TttConfig config;
+        for (int i = 1; i < argc; i += 2) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            std::string value = argv[i + 1];
+            if (arg == "--laws") config.laws = split_list(value);
+            else if (arg == "--threads") {
+                config.threads.clear();
+                for (const auto &item : split_list(value)) config.threads.push_back(std::stoi(item));
+            } else if (arg == "--mutations") config.mutations = split_list(value);
+            else if (arg == "--runs") config.runs = std::stoi(value);
+            else if (arg == "--targets") {
+                config.targets.clear();
+                for (const auto &item : split_list(value)) config.targets.push_back(std::stod(item));
+            } else if (arg == "--jobs") config.jobs = std::stoi(value);
+            else if (arg == "--processors") config.processors = std::stoi(value);
+            else if (arg == "--timeout") config.timeout = std::stod(value);
+            else if (arg == "--seed") config.seed = std::stoul(value);
+            else if (arg == "--stagnation") {
+                config.stagnation = std::stoi(value);
+                validate_stagnation_limit(config.stagnation);
+            }
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+        // Пустая сетка или ноль запусков не дают ни одного времени для квантилей и профилей
+        if (config.laws.empty() || config.threads.empty() || config.mutations.empty() || config.targets.empty()) {
+            throw std::runtime_error("--laws, --threads, --mutations and --targets must list at least one value");
+        }
+        if (config.runs < 1) throw std::runtime_error("--runs must be positive");
+        for (int threads : config.threads) {
+            if (threads < 1) throw std::runtime_error("--threads values must be positive");
+        }
+        // Пороги по убыванию: каждый следующий труднее
+        std::sort(config.targets.rbegin(), config.targets.rend());
+
+        std::vector<uint32_t> base = load_jobs("jobs.csv");
+        std::vector<uint32_t> jobs = config.jobs > 0 ? make_instance(base, config.jobs, config.seed) : base;
+
+        std::vector<SolverSetup> setups;
+        for (const auto &law : config.laws)
+            for (int threads : config.threads)
+                for (const auto &mutation : config.mutations)
+                    setups.push_back({law, threads, mutation});
+
+        // runs[s][r] — запуск r конфигурации s; запуск r у всех конфигураций с одним зерном
+        std::vector<std::vector<TttRun>> runs(setups.size());
+        std::ofstream raw("ttt_runs.csv");
+        raw << "Config,Law,Threads,Mutation,Run,Seed,Target,Time,FinalCost,TotalTime" << std::endl;
+        for (size_t s = 0; s < setups.size(); ++s) {
+            const SolverSetup &setup = setups[s];
+            for (int r = 0; r < config.runs; ++r) {
+                unsigned int seed = derive_seed(config.seed, r, 0);
+                runs[s].push_back(run_once(config, setup, jobs, seed));
+                const TttRun &run = runs[s].back();
+                for (size_t t = 0; t < config.targets.size(); ++t) {
+                    raw << setup.name() << "," << setup.law << "," << setup.threads << "," << setup.mutation << ","
+                        << r << "," << seed << "," << config.targets[t] << ",";
+                    if (!std::isinf(run.times[t])) raw << run.times[t];
+                    raw << "," << run.final_cost << "," << run.total_time << "\n";
+                }
+            }
+            std::cout << "Config " << setup.name() << ": " << config.runs << " runs done" << std::endl;
+        }
+
+        // Эмпирическое распределение: i-е по возрастанию время получает вероятность (i + 0.5) / runs;
+        // недостигнутые запуски не попадают в таблицу, и кривая не доходит до 1
+        std::ofstream distribution("ttt_distribution.csv");
+        distribution << "Config,Target,Rank,Time,Probability" << std::endl;
+        std::cout << "\nConfig, target: success, median, p90 time (s)\n";
+        for (size_t s = 0; s < setups.size(); ++s) {
+            for (size_t t = 0; t < config.targets.size(); ++t) {
+                std::vector<double> times;
+                for (const auto &run : runs[s]) times.push_back(run.times[t]);
+                std::vector<double> finite;
+                for (double time : times) if (!std::isinf(time)) finite.push_back(time);
+                std::sort(finite.begin(), finite.end());
+                for (size_t i = 0; i < finite.size(); ++i) {
+                    distribution << setups[s].name() << "," << config.targets[t] << "," << i << "," << finite[i]
+                                 << "," << (i + 0.5) / config.runs << "\n";
+                }
+                std::cout << "  " << setups[s].name() << ", " << config.targets[t] << ": "
+                          << finite.size() << "/" << config.runs << ", "
+                          << time_quantile(times, 0.5) << ", " << time_quantile(times, 0.9) << "\n";
+            }
+        }
+
+        // Профиль производительности: задача — пара (порог, запуск), отношение — время
+        // конфигурации к лучшему времени на этой задаче; доля задач с отношением не больше tau
+        std::vector<std::vector<double>> ratios(setups.size());
+        for (size_t t = 0; t < config.targets.size(); ++t) {
+            for (int r = 0; r < config.runs; ++r) {
+                double fastest = INFINITY;
+                for (size_t s = 0; s < setups.size(); ++s) fastest = std::min(fastest, runs[s][r].times[t]);
+                if (std::isinf(fastest)) continue;
+                for (size_t s = 0; s < setups.size(); ++s) {
+                    ratios[s].push_back(runs[s][r].times[t] / std::max(fastest, 1e-9));
+                }
+            }
+        }
+        std::vector<double> taus;
+        for (const auto &config_ratios : ratios)
+            for (double ratio : config_ratios)
+                if (!std::isinf(ratio)) taus.push_back(ratio);
+        std::sort(taus.begin(), taus.end());
+        taus.erase(std::unique(taus.begin(), taus.end()), taus.end());
+        std::ofstream profile("performance_profile.csv");
+        profile << "Config,Tau,Fraction" << std::endl;
+        for (size_t s = 0; s < setups.size(); ++s) {
+            std::sort(ratios[s].begin(), ratios[s].end());
+            for (double tau : taus) {
+                size_t solved = std::upper_bound(ratios[s].begin(), ratios[s].end(), tau) - ratios[s].begin();
+                profile << setups[s].name() << "," << tau << ","
+                        << (ratios[s].empty() ? 0.0 : static_cast<double>(solved) / ratios[s].size()) << "\n";
+            }
+        }
+
+        std::cout << "Данные сохранены в ttt_runs.csv, ttt_distribution.csv и performance_profile.csv\n";
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}